@@ -0,0 +1,285 @@
+#include "batch.h"
+#include "../output/output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <pthread.h>
+
+// Reallocate 16 entries per realloc() call
+#define ENTRIES_PER_ALLOC 16
+
+/**
+ * How many dictionaries may be loaded ahead of the one currently being handed out.
+ * Every loaded dictionary holds on to its words and neighbor lists, so keep it small.
+ */
+#define BATCH_LOOKAHEAD 1
+
+/** A single dictionary from the manifest. */
+typedef struct {
+    /** Path to the words file. */
+    char *path;
+
+    /** Options for this dictionary's context. */
+    wordle_options_t options;
+
+    /** The context, set by the loader. NULL if it could not be loaded. */
+    wordle_t *wordle;
+
+    /** Error from creating, loading or solving the context. */
+    int error;
+
+    /** How the solutions are printed. */
+    output_t output;
+} batch_entry_t;
+
+/** State shared between the loader thread and the thread handing out chunks. */
+typedef struct {
+    batch_entry_t *entries;
+    int entry_count;
+
+    /** Number of entries loaded so far. */
+    int loaded;
+
+    /** Number of entries that had all of their chunks handed out. */
+    int dispatched;
+
+    /** Protects `loaded` and `dispatched`. */
+    pthread_mutex_t mutex;
+
+    /** Signals whenever `loaded` or `dispatched` changes. */
+    pthread_cond_t changed;
+} batch_t;
+
+/**
+ * Reads the manifest.
+ *
+ * @param batch Entries are stored in here.
+ * @param manifest Path to the manifest.
+ * @param defaults Options for entries that don't specify their own.
+ */
+static void read_manifest(batch_t *batch, const char *manifest, const wordle_options_t *defaults) {
+    FILE *file = fopen(manifest, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening manifest %s: ", manifest);
+        perror(NULL);
+        exit(EXIT_FAILURE);
+    }
+
+    int allocated = 0;
+    batch->entries = NULL;
+    batch->entry_count = 0;
+
+    // Every field fits in a line, so none of them can be cut short and spill into the next
+    char line[4096];
+    char path[4096];
+    char words_str[4096];
+    char order_str[4096];
+    char rest;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        wordle_options_t options = *defaults;
+        int fields = sscanf(line, "%4095s %4095s %4095s %c", path, words_str, order_str, &rest);
+
+        // Empty line or a comment
+        if (fields < 1 || path[0] == '#') {
+            continue;
+        }
+
+        if (fields > 3) {
+            fprintf(stderr, "%s: unexpected text after the word order\n", path);
+            exit(EXIT_FAILURE);
+        }
+
+        if (fields >= 2) {
+            char *end;
+            long words_per_thread = strtol(words_str, &end, 10);
+
+            if (*end != '\0' || words_per_thread <= 0 || words_per_thread > INT_MAX) {
+                fprintf(stderr, "%s: words per thread must be a positive number, got %s\n", path, words_str);
+                exit(EXIT_FAILURE);
+            }
+
+            options.words_per_thread = (int) words_per_thread;
+        }
+
+        if (fields == 3 && (options.order = wordle_parse_order(order_str)) == WORDLE_ORDER_COUNT) {
+            fprintf(stderr, "%s: unknown word order %s\n", path, order_str);
+            exit(EXIT_FAILURE);
+        }
+
+        if (batch->entry_count >= allocated) {
+            allocated += ENTRIES_PER_ALLOC;
+            batch->entries = realloc(batch->entries, allocated * sizeof(batch_entry_t));
+            if (batch->entries == NULL) {
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        batch_entry_t *entry = &batch->entries[batch->entry_count++];
+        memset(entry, 0, sizeof(batch_entry_t));
+        entry->path = strdup(path);
+        entry->options = options;
+
+        if (entry->path == NULL) {
+            perror("strdup");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fclose(file);
+}
+
+/**
+ * Loads the dictionaries one after the other, staying at most
+ * BATCH_LOOKAHEAD dictionaries ahead of the ones handed out.
+ */
+static void* loader(void *arg) {
+    batch_t *batch = (batch_t *) arg;
+
+    for (int i = 0; i < batch->entry_count; i++) {
+        pthread_mutex_lock(&batch->mutex);
+        while (i > batch->dispatched + BATCH_LOOKAHEAD) {
+            pthread_cond_wait(&batch->changed, &batch->mutex);
+        }
+        pthread_mutex_unlock(&batch->mutex);
+
+        batch_entry_t *entry = &batch->entries[i];
+        entry->error = wordle_create(&entry->wordle, &entry->options);
+        if (entry->error == WORDLE_OK) {
+            entry->error = wordle_load(entry->wordle, entry->path);
+        }
+
+        if (entry->error != WORDLE_OK) {
+            wordle_destroy(entry->wordle);
+            entry->wordle = NULL;
+        }
+
+        pthread_mutex_lock(&batch->mutex);
+        batch->loaded++;
+        pthread_cond_signal(&batch->changed);
+        pthread_mutex_unlock(&batch->mutex);
+    }
+
+    return NULL;
+}
+
+/**
+ * Waits for a dictionary's search to finish, reports its stats and frees it,
+ * the next dictionaries may need the memory.
+ *
+ * @param entry The dictionary.
+ * @param verbose Print the stats.
+ */
+static void finish_entry(batch_entry_t *entry, int verbose) {
+    if (entry->wordle == NULL) {
+        fprintf(stderr, "%s: %s\n", entry->path, wordle_strerror(entry->error));
+        return;
+    }
+
+    wordle_solve_wait(entry->wordle);
+
+    if (entry->error != WORDLE_OK) {
+        fprintf(stderr, "%s: %s\n", entry->path, wordle_strerror(entry->error));
+    } else if (verbose) {
+        wordle_stats_t stats;
+        wordle_get_stats(entry->wordle, &stats);
+
+        printf(
+            "%s: %d usable words out of %d, loaded in %.2f ms, searched in %.2f ms (%s order), checked ",
+            entry->path,
+            stats.word_count,
+            stats.words_encountered,
+            stats.load_ms,
+            stats.solve_ms,
+            wordle_order_name(stats.order)
+        );
+        print_number(stats.leaves);
+        printf(" five-word combination leaves.\n");
+
+        if (stats.cache_bytes > 0) {
+            printf("%s: ", entry->path);
+            print_cache_stats(&stats);
+        }
+    }
+
+    wordle_destroy(entry->wordle);
+    entry->wordle = NULL;
+}
+
+int batch_run(const char *manifest, const wordle_options_t *defaults, int verbose) {
+    batch_t batch = {
+        .loaded = 0,
+        .dispatched = 0
+    };
+
+    read_manifest(&batch, manifest, defaults);
+
+    if (pthread_mutex_init(&batch.mutex, NULL) != 0) {
+        perror("pthread_mutex_init");
+        exit(EXIT_FAILURE);
+    }
+
+    if (pthread_cond_init(&batch.changed, NULL) != 0) {
+        perror("pthread_cond_init");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_t loader_tid;
+    if (pthread_create(&loader_tid, NULL, loader, &batch) != 0) {
+        perror("pthread_create");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < batch.entry_count; i++) {
+        // Wait for the loader to get to this dictionary
+        pthread_mutex_lock(&batch.mutex);
+        while (batch.loaded <= i) {
+            pthread_cond_wait(&batch.changed, &batch.mutex);
+        }
+        pthread_mutex_unlock(&batch.mutex);
+
+        batch_entry_t *entry = &batch.entries[i];
+        if (entry->wordle != NULL) {
+            entry->output.tag = entry->path;
+            entry->output.verbose = verbose;
+            entry->output.scored = entry->options.top_k > 0;
+
+            // Returns once the last chunk has been handed out, the threads are
+            // still busy with this dictionary while we move on to the next one.
+            entry->error = wordle_solve_start(entry->wordle, print_solution, &entry->output);
+        }
+
+        pthread_mutex_lock(&batch.mutex);
+        batch.dispatched++;
+        pthread_cond_signal(&batch.changed);
+        pthread_mutex_unlock(&batch.mutex);
+
+        // The previous dictionary is being finished up by the threads
+        // this one didn't get, so it's about to be done.
+        if (i > 0) {
+            finish_entry(&batch.entries[i - 1], verbose);
+        }
+    }
+
+    if (batch.entry_count > 0) {
+        finish_entry(&batch.entries[batch.entry_count - 1], verbose);
+    }
+
+    pthread_join(loader_tid, NULL);
+
+    int failed = 0;
+    for (int i = 0; i < batch.entry_count; i++) {
+        if (batch.entries[i].error != WORDLE_OK) {
+            failed++;
+        }
+        free(batch.entries[i].path);
+    }
+    free(batch.entries);
+
+    pthread_mutex_destroy(&batch.mutex);
+    pthread_cond_destroy(&batch.changed);
+
+    return failed;
+}
@@ -0,0 +1,32 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "../wordle/wordle.h"
+
+/**
+ * Solves every dictionary listed in a manifest file.
+ *
+ * The manifest contains one dictionary per line, optionally followed by
+ * the number of words per thread and the word order to use for that dictionary:
+ *
+ *     themes/animals.txt
+ *     themes/food.txt 4
+ *     themes/plants.txt 10 degeneracy
+ *
+ * Empty lines and lines starting with `#` are ignored.
+ *
+ * All dictionaries share the threads of `defaults->pool`. While one dictionary is being
+ * searched, the next one is already being loaded, and its chunks are handed out
+ * as soon as the previous dictionary's chunks have all been handed out, so no
+ * thread sits idle between two dictionaries.
+ *
+ * Results and stats are prefixed with the path of the dictionary they belong to.
+ *
+ * @param manifest Path to the manifest file.
+ * @param defaults Options for dictionaries that don't specify their own, must have a pool.
+ * @param verbose Print stats and thread information.
+ * @return int Number of dictionaries that could not be solved.
+ */
+int batch_run(const char *manifest, const wordle_options_t *defaults, int verbose);
+
+#endif
@@ -1,160 +1,113 @@
-#include "words/words.h"
-#include "threads/threads.h"
-#include <math.h>
+#include "wordle/wordle.h"
+#include "batch/batch.h"
+#include "output/output.h"
+#include <time.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <sys/time.h>
+#include <string.h>
 
-extern thread_manager_t thread_manager;
-
-/**
- * Default options.
- *
- * These values are determined from the `time.js` / `time.txt` output.
- * These work the best for my 8 core machine.
- */
 static int VERBOSE = 1;
-static int MAX_THREADS = 8;
-static int WORDS_PER_THREAD = 10;
-
-// Count of all words that we're working with
-static int word_count = 0;
-static word_t *all_words = NULL;
 
 /**
- * The thread itself. Given a thread argument, which tells the thread the range
- * to search through.
+ * Solver options, the library's defaults from `wordle_options_init`
+ * with whatever was given on the command line.
+ * Used as is for a single words.txt, and as the defaults for every dictionary in batch mode.
  */
-static void* thread(void *arg) {
-    thread_arg_t *data = (thread_arg_t *) arg;
-    unsigned long long int work_done = 0;
-
-    for (int i = data->start; i < data->end; i++) {
-        // Grab the first word
-        word_t word_1 = all_words[i];
-        uint32_t n1 = word_1.numeric;
-
-        // Only iterate through the words that we know don't overlap with the first word
-        for (int j = 0; j < word_1.neighbors_n; j++) {
-            // Grab the index of the second word choice
-            int index_2 = word_1.neighbors[j];
-            // Retrieve that word
-            word_t word_2 = all_words[index_2];
-            uint32_t n2 = word_2.numeric;
-
-            for (int k = 0; k < word_2.neighbors_n; k++) {
-                // Grab the index for the third word
-                int index_3 = word_2.neighbors[k];
-
-                word_t word_3 = all_words[index_3];
-                uint32_t n3 = word_3.numeric;
-
-                // Check if the first and the third word overlap in characters
-                if ((n1 & n3) != 0) {
-                    continue;
-                }
-
-                /**
-                 * Represents a union of the first and the second words,
-                 * Because in order to find a fourth word, we don't need
-                 * to check if the fourth word overlaps with the third one
-                 * since we're only going through the words that don't overlap
-                 * with the third one, but we do need to check if the 4th word
-                 * overlaps with either the first or the second.
-                 * Basically for any word at position `n` we know
-                 * it doesn't overlap with `n - 1`, but we have to check for (0..n-2).
-                 */
-                uint32_t n12 = n1 | n2;
-                for (int l = 0; l < word_3.neighbors_n; l++) {
-                    int index_4 = word_3.neighbors[l];
-
-                    word_t word_4 = all_words[index_4];
-                    uint32_t n4 = word_4.numeric;
-
-                    if ((n12 & n4) != 0) {
-                        continue;
-                    }
-
-                    uint32_t n123 = n12 | n3;
-                    for (int m = 0; m < word_4.neighbors_n; m++) {
-                        int index_5 = word_4.neighbors[m];
-
-                        word_t word_5 = all_words[index_5];
-                        uint32_t n5 = word_5.numeric;
-                        work_done++;
-
-                        if ((n123 & n5) != 0) {
-                            continue;
-                        }
-
-                        if (VERBOSE) {
-                            printf(
-                                "thread #%03d   chunk[%04d-%04d]: %s %s %s %s %s\n",
-                                data->id,
-                                data->start,
-                                data->end,
-                                word_1.str,
-                                word_2.str,
-                                word_3.str,
-                                word_4.str,
-                                word_5.str
-                            );
-                        } else {
-                            printf(
-                                "%s %s %s %s %s\n",
-                                word_1.str,
-                                word_2.str,
-                                word_3.str,
-                                word_4.str,
-                                word_5.str
-                            );
-                        }
-                    }
-                }
-            }
-        }
-    }
+static wordle_options_t OPTIONS;
 
-    mutex_lock();
-    if (thread_manager.thread_count == thread_manager.max_threads) {
-        pthread_cond_signal(&thread_manager.can_create_thread);
-    }
+// Manifest of dictionaries to solve in batch mode, NULL for a single words.txt
+static char *MANIFEST = NULL;
 
-    thread_manager.thread_count--;
-    thread_manager.work_done += work_done;
-    data->running = false;
+// Try out every ordering instead of searching once
+static bool COMPARE_ORDERS = false;
 
-    if (thread_manager.thread_count == 0) {
-        pthread_cond_signal(&thread_manager.all_threads_finished);
-    }
-    mutex_unlock();
+// Long-only options
+enum {
+    OPTION_TOP = 256,
+    OPTION_SCORE
+};
 
-    return NULL;
-}
+static const struct option LONG_OPTIONS[] = {
+    { "top", required_argument, NULL, OPTION_TOP },
+    { "score", required_argument, NULL, OPTION_SCORE },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+};
 
 static void parse_options(int argc, char *argv[]) {
+    wordle_options_init(&OPTIONS);
+
     int ch;
-    while ((ch = getopt(argc, argv, "t:w:hs")) != -1) {
+    long number;
+    while ((ch = getopt_long(argc, argv, "t:w:b:o:c:hs", LONG_OPTIONS, NULL)) != -1) {
         switch (ch) {
             case 't':
-                MAX_THREADS = atoi(optarg);
+                OPTIONS.max_threads = atoi(optarg);
                 break;
 
             case 'w':
-                WORDS_PER_THREAD = atoi(optarg);
+                OPTIONS.words_per_thread = atoi(optarg);
                 break;
 
             case 's':
                 VERBOSE = 0;
                 break;
+
+            case 'b':
+                MANIFEST = optarg;
+                break;
+
+            case 'o':
+                if (strcmp(optarg, "all") == 0) {
+                    COMPARE_ORDERS = true;
+                    break;
+                }
+
+                OPTIONS.order = wordle_parse_order(optarg);
+                if (OPTIONS.order == WORDLE_ORDER_COUNT) {
+                    fprintf(stderr, "Unknown word order: %s\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'c':
+                number = atol(optarg);
+                if (number < 0) {
+                    fprintf(stderr, "-c needs a number of cache entries, 0 to not cache\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                OPTIONS.cache_entries = (size_t) number;
+                break;
+
+            case OPTION_TOP:
+                number = atol(optarg);
+                if (number <= 0) {
+                    fprintf(stderr, "--top needs a positive number of solutions\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                OPTIONS.top_k = (size_t) number;
+                break;
+
+            case OPTION_SCORE:
+                OPTIONS.score = wordle_parse_score(optarg);
+                if (OPTIONS.score == WORDLE_SCORE_COUNT) {
+                    fprintf(stderr, "Unknown score model: %s\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
             
             case 'h':
             default:
                 fprintf(
                     stderr,
-                    "usage: ./wordle [-t thread] [-w words_per_thread] [-s] [-h]\n\n"
+                    "usage: ./wordle [-t thread] [-w words_per_thread] [-o order] [-b manifest]\n"
+                    "                [-c cache_entries] [--top K [--score model]] [-s] [-h]\n\n"
 
                     "-h help\n\n"
 
@@ -166,21 +119,88 @@ static void parse_options(int argc, char *argv[]) {
                     "-w words_per_thread\n"
                     "    number of words each thread should check.\n"
                     "    -w 8 would tell thread to pick 8 words and try\n"
-                    "    all combinations where either of these 8 words are the word #1\n"
+                    "    all combinations where either of these 8 words are the word #1\n\n"
+
+                    "-o order\n"
+                    "    order to search the words in, one of numeric (default), rarest,\n"
+                    "    degree-asc, degree-desc or degeneracy. -o all searches once\n"
+                    "    with every order, without the cache, and reports the leaves checked and time taken\n\n"
+
+                    "-b manifest\n"
+                    "    batch mode, solve every dictionary listed in the manifest,\n"
+                    "    one path per line, optionally followed by words_per_thread\n"
+                    "    and order for that dictionary. All dictionaries share the same threads\n"
+                    "    and results are prefixed with the dictionary's path\n\n"
+
+                    "-c cache_entries\n"
+                    "    max size of the cache of ways to finish a solution given the first\n"
+                    "    three words, shared by all threads. 32 bytes per entry,\n"
+                    "    sized from the number of words up to 1048576 by default, 0 to not cache\n\n"
+
+                    "--top K\n"
+                    "    only print the K best scoring solutions, best first.\n"
+                    "    A solution's score is the sum of its words' scores\n\n"
+
+                    "--score model\n"
+                    "    how to score the words for --top, one of\n"
+                    "    frequency (default), from an optional second column in the words file\n"
+                    "    letters, by how many of the words use each of the word's letters\n"
                 );
                 exit(ch == '?' ? EXIT_FAILURE : EXIT_SUCCESS);
         }
     }
 }
 
-static void print_number(unsigned long long int n) {
-    if (n < 1000) {
-        printf("%llu", n);
-        return;
+/**
+ * Exits if a library call failed.
+ *
+ * @param error wordle_error_t returned by the call.
+ * @param what What failed, printed along with the error.
+ */
+static void check(int error, const char *what) {
+    if (error != WORDLE_OK) {
+        fprintf(stderr, "%s: %s\n", what, wordle_strerror(error));
+        exit(EXIT_FAILURE);
     }
+}
+
+/**
+ * Searches through the words once with every ordering, without printing the results.
+ * Reports how long each ordering took to build and to search, and how many leaves it checked.
+ * The cache is turned off, how many leaves it saves depends on the timing of the threads,
+ * so the orders wouldn't be compared on the same search.
+ *
+ * @param wordle Context with the words loaded, left in the last ordering with the cache off.
+ */
+static void compare_orders(wordle_t *wordle) {
+    wordle_order_t best = WORDLE_ORDER_NUMERIC;
+    unsigned long long int best_leaves = 0;
+
+    check(wordle_set_cache(wordle, 0), "Turning off the cache");
+
+    for (int order = 0; order < WORDLE_ORDER_COUNT; order++) {
+        check(wordle_set_order(wordle, order), "Ordering the words");
+        check(wordle_solve(wordle, NULL, NULL), "Solving");
+
+        wordle_stats_t stats;
+        wordle_get_stats(wordle, &stats);
 
-    print_number(n / 1000);
-    printf(",%03llu", n % 1000);
+        printf(
+            "%-12s built in %8.2f ms, searched in %9.2f ms, checked ",
+            wordle_order_name(order),
+            stats.load_ms,
+            stats.solve_ms
+        );
+        print_number(stats.leaves);
+        printf(" leaves.\n");
+
+        if (order == WORDLE_ORDER_NUMERIC || stats.leaves < best_leaves) {
+            best = order;
+            best_leaves = stats.leaves;
+        }
+    }
+
+    printf("\nFewest leaves checked with the %s order.\n", wordle_order_name(best));
 }
 
 int main(int argc, char *argv[]) {
@@ -188,79 +208,86 @@ int main(int argc, char *argv[]) {
     clock_gettime(CLOCK_REALTIME, &start);
 
     parse_options(argc, argv);
-    thread_manager_init(MAX_THREADS);
-    word_results_t word_results = load_words();
 
-    all_words = word_results.all_words;
-    word_count = word_results.word_count;
+    wordle_pool_t *pool;
+    check(wordle_pool_create(&pool, OPTIONS.max_threads), "Creating threads");
+    OPTIONS.pool = pool;
 
-    if (VERBOSE) {
-        printf(
-            "Loading words done...\n"
-            "Encountered %d hashmap collisions while filtering out anagrams.\n"
-            "Left with %d usable words out of the %d total words in the file.\n\n",
-            word_results.collisions,
-            word_count,
-            word_results.words_encountered
-        );
+    int exit_code = EXIT_SUCCESS;
 
-        printf(
-            "Starting processing: max_threads = %d, words_per_thread = %d\n\n",
-            MAX_THREADS,
-            WORDS_PER_THREAD
-        );
-    }
+    // Stats of the single solve, zeroed in batch mode which prints them per dictionary
+    wordle_stats_t solve_stats = { 0 };
 
-    /**
-     * The whole search space is divided into chunks now, since we're using
-     * WORDS_PER_THREAD.
-     * Each thread gets passed a chunk to process, size of WORDS_PER_THREAD.
-     * So we want to process all chunks and we want to keep
-     * re-creating threads until all chunks are processed.
-     */
-    int next_chunk_index = 0;
-    int total_chunks = (int) ceil((double) word_count / (double) WORDS_PER_THREAD);
-
-    while (next_chunk_index < total_chunks) {
-        // Waits for threads to become available, which on the first iteration will be
-        // immediately
-        mutex_wait_for_thread_availability();
-
-        /**
-         * Critical section. Creating new threads and updating the thread count.
-         * Create as many threads as possible on this iteration.
-         * 
-         * On the first iteration, max_threads will be created, on every next iteration
-         * we'll see. Probably only 1 thread at a time, but perhaps more.
-         */
-        for (int i = thread_manager.thread_count; i < thread_manager.max_threads; i++) {
-            thread_arg_t arg = {
-                .id = next_chunk_index,
-                // .running should be here but create_thread does it for us
-                .start = next_chunk_index * WORDS_PER_THREAD,
-                .end = (next_chunk_index + 1) * WORDS_PER_THREAD
-            };
+    if (MANIFEST != NULL) {
+        if (COMPARE_ORDERS) {
+            fprintf(stderr, "-o all can't be used in batch mode, pick an order per dictionary instead\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (VERBOSE) {
+            printf(
+                "Starting batch processing of %s: max_threads = %d, words_per_thread = %d, order = %s\n\n",
+                MANIFEST,
+                OPTIONS.max_threads,
+                OPTIONS.words_per_thread,
+                wordle_order_name(OPTIONS.order)
+            );
+        }
 
-            // Last chunk
-            if (arg.end >= word_count) {
-                arg.end = word_count;
+        if (batch_run(MANIFEST, &OPTIONS, VERBOSE) > 0) {
+            exit_code = EXIT_FAILURE;
+        }
+    } else {
+        wordle_t *wordle;
+        check(wordle_create(&wordle, &OPTIONS), "Creating the solver");
+        check(wordle_load(wordle, "words.txt"), "words.txt");
+
+        if (VERBOSE) {
+            wordle_stats_t stats;
+            wordle_get_stats(wordle, &stats);
+
+            printf(
+                "Loading words done...\n"
+                "Encountered %d hashmap collisions while filtering out anagrams.\n"
+                "Left with %d usable words out of the %d total words in the file.\n\n",
+                stats.collisions,
+                stats.word_count,
+                stats.words_encountered
+            );
+
+            printf(
+                "Starting processing: max_threads = %d, words_per_thread = %d, order = %s",
+                OPTIONS.max_threads,
+                OPTIONS.words_per_thread,
+                COMPARE_ORDERS ? "all" : wordle_order_name(OPTIONS.order)
+            );
+
+            if (OPTIONS.top_k > 0) {
+                printf(", top %zu by %s", OPTIONS.top_k, wordle_score_name(OPTIONS.score));
             }
 
-            create_thread(arg, thread);
-            next_chunk_index++;
+            printf("\n\n");
+        }
 
-            if (next_chunk_index == total_chunks) {
-                break;
-            }
+        if (COMPARE_ORDERS) {
+            compare_orders(wordle);
+        } else {
+            output_t output = {
+                .tag = NULL,
+                .verbose = VERBOSE,
+                .scored = OPTIONS.top_k > 0
+            };
+
+            check(wordle_solve(wordle, print_solution, &output), "Solving");
+
+            wordle_get_stats(wordle, &solve_stats);
         }
 
-        mutex_unlock();
+        wordle_destroy(wordle);
     }
 
-    mutex_wait_for_all_threads_to_finish();
-    mutex_unlock();
-    cleanup_words(all_words, word_count);
-    thread_manager_cleanup();
+    unsigned long long int leaves = wordle_pool_leaves(pool);
+    wordle_pool_destroy(pool);
 
     clock_gettime(CLOCK_REALTIME, &end);
 
@@ -269,9 +296,13 @@ int main(int argc, char *argv[]) {
     if (VERBOSE) {
         printf("\nFinished after %.2f milliseconds.\n", delta / 1E6F);
         printf("Checked ");
-        print_number(thread_manager.work_done);
+        print_number(leaves);
         printf(" five-word combination leaves.\n");
+
+        if (solve_stats.cache_bytes > 0) {
+            print_cache_stats(&solve_stats);
+        }
     }
 
-    return 0;
+    return exit_code;
 }
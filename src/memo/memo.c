@@ -0,0 +1,168 @@
+#include "memo.h"
+#include "../wordle/wordle.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Bucket a key goes in. Masks of similar letters only differ in a few bits,
+ * so they're mixed first to spread them over the whole table.
+ *
+ * @param memo The cache.
+ * @param mask The key.
+ * @return memo_slot_t* First slot of the bucket.
+ */
+static memo_slot_t* bucket_of(memo_t *memo, uint32_t mask) {
+    uint32_t hash = mask * 0x9E3779B1u;
+    hash ^= hash >> 15;
+
+    return &memo->slots[(hash & memo->bucket_mask) * MEMO_WAYS];
+}
+
+int memo_init(memo_t *memo, size_t entries) {
+    size_t buckets = 1;
+    while (buckets * MEMO_WAYS < entries) {
+        buckets *= 2;
+    }
+
+    size_t bytes = buckets * MEMO_WAYS * sizeof(memo_slot_t);
+
+    // A bucket is 128 bytes, keep it to two cache lines
+    memo->slots = (memo_slot_t *) aligned_alloc(64, bytes);
+    if (memo->slots == NULL) {
+        return WORDLE_ERR_NO_MEMORY;
+    }
+
+    memset(memo->slots, 0, bytes);
+    memo->bucket_mask = buckets - 1;
+    atomic_init(&memo->clock, 0);
+
+    return WORDLE_OK;
+}
+
+void memo_cleanup(memo_t *memo) {
+    free(memo->slots);
+    memo->slots = NULL;
+}
+
+size_t memo_bytes(const memo_t *memo) {
+    return (memo->bucket_mask + 1) * MEMO_WAYS * sizeof(memo_slot_t);
+}
+
+uint32_t memo_tick(memo_t *memo) {
+    return atomic_fetch_add_explicit(&memo->clock, 1, memory_order_relaxed) + 1;
+}
+
+bool memo_lookup(memo_t *memo, uint32_t mask, int after, uint32_t age, memo_entry_t *entry, memo_counters_t *counters) {
+    memo_slot_t *bucket = bucket_of(memo, mask);
+
+    counters->lookups++;
+
+    for (int i = 0; i < MEMO_WAYS; i++) {
+        memo_slot_t *slot = &bucket[i];
+
+        uint32_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (atomic_load_explicit(&slot->mask, memory_order_relaxed) != mask) {
+            continue;
+        }
+
+        // Being written
+        if (sequence & 1) {
+            return false;
+        }
+
+        uint32_t info = atomic_load_explicit(&slot->info, memory_order_relaxed);
+        entry->after = info & 0xFFFF;
+        entry->count = info >> 16;
+        for (int j = 0; j < entry->count && j < MEMO_PAIRS; j++) {
+            entry->pairs[j] = atomic_load_explicit(&slot->pairs[j], memory_order_relaxed);
+        }
+
+        // Everything above has to be read before checking nobody wrote to the slot meanwhile
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) != sequence) {
+            return false;
+        }
+
+        // Made for a later third word, misses completions with the fourth word in between
+        if (entry->after > after) {
+            return false;
+        }
+
+        // Only written once per chunk, so threads don't keep invalidating each other's caches
+        if (atomic_load_explicit(&slot->age, memory_order_relaxed) != age) {
+            atomic_store_explicit(&slot->age, age, memory_order_relaxed);
+        }
+
+        counters->hits++;
+        return true;
+    }
+
+    return false;
+}
+
+void memo_insert(memo_t *memo, uint32_t mask, const memo_entry_t *entry, uint32_t age, memo_counters_t *counters) {
+    memo_slot_t *bucket = bucket_of(memo, mask);
+    memo_slot_t *victim = NULL;
+    uint32_t victim_mask = 0;
+
+    /**
+     * An entry for the same letters is always the one replaced, the new one
+     * was made for an earlier third word so it holds everything the old one did.
+     * Otherwise an empty slot, or the one used the longest ago.
+     */
+    for (int i = 0; i < MEMO_WAYS; i++) {
+        memo_slot_t *slot = &bucket[i];
+        uint32_t slot_mask = atomic_load_explicit(&slot->mask, memory_order_relaxed);
+
+        if (slot_mask == mask) {
+            // Another thread got here first
+            uint32_t info = atomic_load_explicit(&slot->info, memory_order_relaxed);
+            if ((int) (info & 0xFFFF) <= entry->after) {
+                return;
+            }
+
+            victim = slot;
+            victim_mask = slot_mask;
+            break;
+        }
+
+        if (victim != NULL && victim_mask == 0) {
+            continue;
+        }
+
+        if (
+            victim == NULL ||
+            slot_mask == 0 ||
+            atomic_load_explicit(&slot->age, memory_order_relaxed) <
+            atomic_load_explicit(&victim->age, memory_order_relaxed)
+        ) {
+            victim = slot;
+            victim_mask = slot_mask;
+        }
+    }
+
+    uint32_t sequence = atomic_load_explicit(&victim->sequence, memory_order_relaxed);
+    if ((sequence & 1) || !atomic_compare_exchange_strong_explicit(
+        &victim->sequence, &sequence, sequence + 1,
+        memory_order_relaxed, memory_order_relaxed
+    )) {
+        return;
+    }
+
+    // Readers seeing any of the writes below have to see the odd sequence too
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&victim->mask, mask, memory_order_relaxed);
+    atomic_store_explicit(&victim->info, (uint32_t) entry->after | (uint32_t) entry->count << 16, memory_order_relaxed);
+    atomic_store_explicit(&victim->age, age, memory_order_relaxed);
+    for (int j = 0; j < entry->count && j < MEMO_PAIRS; j++) {
+        atomic_store_explicit(&victim->pairs[j], entry->pairs[j], memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&victim->sequence, sequence + 2, memory_order_release);
+
+    counters->insertions++;
+    if (victim_mask != 0 && victim_mask != mask) {
+        counters->evictions++;
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef MEMO_H
+#define MEMO_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A cache of the ways to finish a solution, shared by all threads of a search.
+ *
+ * Many different first three words use the same 15 letters, and the words
+ * that can follow them only depend on those letters. Every word's neighbors
+ * are all the non-overlapping words after it, so the fourth and fifth words
+ * of a solution are any two non-overlapping words after the third word which
+ * don't overlap with the first three either. They're found once per set of
+ * letters and third word, and looked up from then on.
+ *
+ * An entry found after third word `a` also holds everything for a later third
+ * word `b`: the completions whose fourth word comes after `b`.
+ *
+ * The table has a fixed size. A key can only go in one bucket, and when the
+ * bucket is full, the entry used the longest ago is replaced. Lookups and
+ * insertions never lock, every slot has a sequence number which is odd while
+ * the slot is being written, so readers can tell when they read a half-written
+ * entry and count it as a miss instead.
+ */
+
+/** Most completions an entry can hold. Letters with more only get marked with `MEMO_TOO_MANY`. */
+#define MEMO_PAIRS 4
+
+/**
+ * `count` of an entry for letters with more than `MEMO_PAIRS` completions.
+ * The pairs aren't stored, the entry only saves going through the words
+ * once more just to find that out again.
+ */
+#define MEMO_TOO_MANY 0xFFFF
+
+/** Slots per bucket. */
+#define MEMO_WAYS 4
+
+/** Ways to finish a solution. */
+typedef struct {
+    /** Index of the third word, only completions with the fourth word after it are included. */
+    int after;
+
+    /** Number of completions, or `MEMO_TOO_MANY`. */
+    int count;
+
+    /** Completions, the fourth word's index in the upper 16 bits and the fifth word's in the lower. */
+    uint32_t pairs[MEMO_PAIRS];
+} memo_entry_t;
+
+/** A slot of the table, 32 bytes so that two fit in a cache line. */
+typedef struct {
+    /** Odd while the slot is being written. */
+    _Atomic uint32_t sequence;
+
+    /** Letters of the first three words, 0 if the slot is empty. */
+    _Atomic uint32_t mask;
+
+    /** `after` in the lower 16 bits and `count` in the upper. */
+    _Atomic uint32_t info;
+
+    /** When the slot was last used, see `memo_tick`. Not covered by `sequence`. */
+    _Atomic uint32_t age;
+
+    _Atomic uint32_t pairs[MEMO_PAIRS];
+} memo_slot_t;
+
+/** Counts how the cache is doing. Kept per thread, and added up at the end. */
+typedef struct {
+    unsigned long long int lookups;
+    unsigned long long int hits;
+    unsigned long long int insertions;
+
+    /** Insertions which replaced an entry for other letters. */
+    unsigned long long int evictions;
+} memo_counters_t;
+
+/** The cache. */
+typedef struct {
+    /** `MEMO_WAYS` slots per bucket. */
+    memo_slot_t *slots;
+
+    /** Number of buckets - 1, the number of buckets is a power of 2. */
+    size_t bucket_mask;
+
+    /** Incremented by `memo_tick`. */
+    _Atomic uint32_t clock;
+} memo_t;
+
+/**
+ * Initializes an empty cache.
+ *
+ * @param memo The cache.
+ * @param entries Number of entries it should hold, rounded up to a power of 2.
+ * @return int wordle_error_t
+ */
+int memo_init(memo_t *memo, size_t entries);
+
+/**
+ * Cleanup.
+ *
+ * @param memo The cache.
+ */
+void memo_cleanup(memo_t *memo);
+
+/**
+ * Memory used by the table.
+ *
+ * @param memo The cache.
+ * @return size_t Bytes.
+ */
+size_t memo_bytes(const memo_t *memo);
+
+/**
+ * Moves the cache's clock forward, once for every chunk of the search.
+ * Entries used during the chunk are stamped with the returned age,
+ * and the oldest entry of a full bucket is the one replaced.
+ *
+ * @param memo The cache.
+ * @return uint32_t The age.
+ */
+uint32_t memo_tick(memo_t *memo);
+
+/**
+ * Looks up the completions of `mask` for a third word at index `after`.
+ * The entry found may have been made for an earlier third word, in which case
+ * it holds completions which aren't valid for this one, with the fourth word
+ * at or before `after`. Those have to be skipped.
+ *
+ * @param memo The cache.
+ * @param mask Letters of the first three words.
+ * @param after Index of the third word.
+ * @param age From `memo_tick`.
+ * @param entry Filled in with the completions when found.
+ * @param counters Counts the lookup.
+ * @return bool Whether there was an entry.
+ */
+bool memo_lookup(memo_t *memo, uint32_t mask, int after, uint32_t age, memo_entry_t *entry, memo_counters_t *counters);
+
+/**
+ * Stores the completions of `mask`, unless another thread is writing to the
+ * slot it would go in, in which case it's just not cached.
+ *
+ * @param memo The cache.
+ * @param mask Letters of the first three words.
+ * @param entry The completions.
+ * @param age From `memo_tick`.
+ * @param counters Counts the insertion.
+ */
+void memo_insert(memo_t *memo, uint32_t mask, const memo_entry_t *entry, uint32_t age, memo_counters_t *counters);
+
+#endif
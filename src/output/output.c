@@ -0,0 +1,72 @@
+#include "output.h"
+#include <stdio.h>
+
+void print_solution(const wordle_solution_t *solution, void *user_data) {
+    output_t *output = (output_t *) user_data;
+    const char *tag = output->tag != NULL ? output->tag : "";
+    const char *tag_separator = output->tag != NULL ? ": " : "";
+
+    // A single printf per solution, so lines from different threads don't mix
+    if (output->scored) {
+        printf(
+            "%s%s%llu: %s %s %s %s %s\n",
+            tag,
+            tag_separator,
+            solution->score,
+            solution->words[0],
+            solution->words[1],
+            solution->words[2],
+            solution->words[3],
+            solution->words[4]
+        );
+    } else if (output->verbose) {
+        printf(
+            "%s%sthread #%03d   chunk[%04d-%04d]: %s %s %s %s %s\n",
+            tag,
+            tag_separator,
+            solution->chunk,
+            solution->chunk_start,
+            solution->chunk_end,
+            solution->words[0],
+            solution->words[1],
+            solution->words[2],
+            solution->words[3],
+            solution->words[4]
+        );
+    } else {
+        printf(
+            "%s%s%s %s %s %s %s\n",
+            tag,
+            tag_separator,
+            solution->words[0],
+            solution->words[1],
+            solution->words[2],
+            solution->words[3],
+            solution->words[4]
+        );
+    }
+}
+
+void print_number(unsigned long long int n) {
+    if (n < 1000) {
+        printf("%llu", n);
+        return;
+    }
+
+    print_number(n / 1000);
+    printf(",%03llu", n % 1000);
+}
+
+void print_cache_stats(const wordle_stats_t *stats) {
+    double hit_rate = stats->cache_lookups > 0
+        ? 100.0 * (double) stats->cache_hits / (double) stats->cache_lookups
+        : 0;
+
+    printf("Cache hit ");
+    print_number(stats->cache_hits);
+    printf(" of ");
+    print_number(stats->cache_lookups);
+    printf(" lookups (%.1f%%), evicted ", hit_rate);
+    print_number(stats->cache_evictions);
+    printf(" entries, using %.1f MB.\n", stats->cache_bytes / (1024.0 * 1024.0));
+}
@@ -0,0 +1,41 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "../wordle/wordle.h"
+#include <stdbool.h>
+
+/** How to print the solutions, passed as the user data to `print_solution`. */
+typedef struct {
+    /** Printed in front of every solution. NULL for none. */
+    const char *tag;
+
+    /** Print the thread and chunk information along with the solutions. */
+    int verbose;
+
+    /** Print the score in front of the solutions, which come best first and without chunk information. */
+    bool scored;
+} output_t;
+
+/**
+ * A `wordle_callback_t` printing the solution to stdout.
+ *
+ * @param solution The solution.
+ * @param user_data An `output_t`.
+ */
+void print_solution(const wordle_solution_t *solution, void *user_data);
+
+/**
+ * Prints a number with thousands separators.
+ *
+ * @param n The number.
+ */
+void print_number(unsigned long long int n);
+
+/**
+ * Prints how the cache did during a solve, on a line of its own.
+ *
+ * @param stats Stats of a solve that used the cache.
+ */
+void print_cache_stats(const wordle_stats_t *stats);
+
+#endif
@@ -0,0 +1,670 @@
+#include "search.h"
+#include <math.h>
+#include <stdio.h>
+
+/** What a thread keeps count of while going through a chunk. */
+typedef struct {
+    /** Leaves checked. */
+    unsigned long long int work_done;
+
+    /** Solutions found. */
+    unsigned long long int solutions;
+
+    /** Cache entries used by the chunk are stamped with this, from `memo_tick`. */
+    uint32_t age;
+
+    /** How the cache did. */
+    memo_counters_t memo;
+} chunk_stats_t;
+
+/**
+ * Finds the ways to finish a solution whose first three words use the letters
+ * `n12 | n3`, the third word being `index_3`. These are looked up in the cache,
+ * or found by going through the fourth and fifth words and cached.
+ *
+ * @param search The search, with a cache.
+ * @param index_3 Index of the third word.
+ * @param n12 Letters of the first two words.
+ * @param n3 Letters of the third word.
+ * @param stats Counts the leaves checked and the cache lookups.
+ * @param completions Filled in with the completions. Ones with the fourth word at
+ *                    or before `index_3` are left over from an earlier third word
+ *                    and have to be skipped.
+ * @return bool false if there are too many completions to cache, or the cache
+ *              says so, in which case the caller has to go through the words itself.
+ */
+static bool find_completions(
+    search_t *search,
+    int index_3,
+    uint32_t n12,
+    uint32_t n3,
+    chunk_stats_t *stats,
+    memo_entry_t *completions
+) {
+    word_t *all_words = search->all_words;
+    uint32_t n123 = n12 | n3;
+
+    if (memo_lookup(&search->memo, n123, index_3, stats->age, completions, &stats->memo)) {
+        return completions->count != MEMO_TOO_MANY;
+    }
+
+    word_t word_3 = all_words[index_3];
+    unsigned long long int work_done_local = 0;
+    bool fits = true;
+
+    completions->after = index_3;
+    completions->count = 0;
+
+    for (int l = 0; l < word_3.neighbors_n && fits; l++) {
+        int index_4 = word_3.neighbors[l];
+        word_t word_4 = all_words[index_4];
+
+        if ((n12 & word_4.numeric) != 0) {
+            continue;
+        }
+
+        for (int m = 0; m < word_4.neighbors_n; m++) {
+            int index_5 = word_4.neighbors[m];
+            work_done_local++;
+
+            if ((n123 & all_words[index_5].numeric) != 0) {
+                continue;
+            }
+
+            if (completions->count == MEMO_PAIRS) {
+                fits = false;
+                break;
+            }
+
+            completions->pairs[completions->count++] = (uint32_t) index_4 << 16 | (uint32_t) index_5;
+        }
+    }
+
+    /**
+     * Cache that there are too many either, so the next lookup sends the caller
+     * straight to going through the words. Leaves checked so far don't count,
+     * the caller checks them all again.
+     */
+    if (!fits) {
+        completions->count = MEMO_TOO_MANY;
+    } else {
+        stats->work_done += work_done_local;
+    }
+
+    memo_insert(&search->memo, n123, completions, stats->age, &stats->memo);
+
+    return fits;
+}
+
+/**
+ * Goes through every combination of the chunk, reporting every solution.
+ *
+ * @param search The search.
+ * @param data The chunk.
+ * @param stats Counts the leaves checked and the solutions found.
+ */
+static void search_all(
+    search_t *search,
+    thread_arg_t *data,
+    chunk_stats_t *stats
+) {
+    word_t *all_words = search->all_words;
+    unsigned long long int work_done_local = 0;
+    unsigned long long int solutions_local = 0;
+
+    for (int i = data->start; i < data->end; i++) {
+        // Grab the first word
+        word_t word_1 = all_words[i];
+        uint32_t n1 = word_1.numeric;
+
+        // Only iterate through the words that we know don't overlap with the first word
+        for (int j = 0; j < word_1.neighbors_n; j++) {
+            // Grab the index of the second word choice
+            int index_2 = word_1.neighbors[j];
+            // Retrieve that word
+            word_t word_2 = all_words[index_2];
+            uint32_t n2 = word_2.numeric;
+
+            for (int k = 0; k < word_2.neighbors_n; k++) {
+                // Grab the index for the third word
+                int index_3 = word_2.neighbors[k];
+
+                word_t word_3 = all_words[index_3];
+                uint32_t n3 = word_3.numeric;
+
+                // Check if the first and the third word overlap in characters
+                if ((n1 & n3) != 0) {
+                    continue;
+                }
+
+                /**
+                 * Represents a union of the first and the second words,
+                 * Because in order to find a fourth word, we don't need
+                 * to check if the fourth word overlaps with the third one
+                 * since we're only going through the words that don't overlap
+                 * with the third one, but we do need to check if the 4th word
+                 * overlaps with either the first or the second.
+                 * Basically for any word at position `n` we know
+                 * it doesn't overlap with `n - 1`, but we have to check for (0..n-2).
+                 */
+                uint32_t n12 = n1 | n2;
+
+                memo_entry_t completions;
+                if (search->memo.slots != NULL && find_completions(search, index_3, n12, n3, stats, &completions)) {
+                    for (int c = 0; c < completions.count; c++) {
+                        int index_4 = completions.pairs[c] >> 16;
+                        int index_5 = completions.pairs[c] & 0xFFFF;
+
+                        if (index_4 <= index_3) {
+                            continue;
+                        }
+
+                        solutions_local++;
+                        if (search->on_solution == NULL) {
+                            continue;
+                        }
+
+                        wordle_solution_t solution = {
+                            .words = {
+                                word_1.str,
+                                word_2.str,
+                                word_3.str,
+                                all_words[index_4].str,
+                                all_words[index_5].str
+                            },
+                            .chunk = data->id,
+                            .chunk_start = data->start,
+                            .chunk_end = data->end,
+                            .score = 0
+                        };
+
+                        search->on_solution(&solution, search->user_data);
+                    }
+                    continue;
+                }
+
+                for (int l = 0; l < word_3.neighbors_n; l++) {
+                    int index_4 = word_3.neighbors[l];
+
+                    word_t word_4 = all_words[index_4];
+                    uint32_t n4 = word_4.numeric;
+
+                    if ((n12 & n4) != 0) {
+                        continue;
+                    }
+
+                    uint32_t n123 = n12 | n3;
+                    for (int m = 0; m < word_4.neighbors_n; m++) {
+                        int index_5 = word_4.neighbors[m];
+
+                        word_t word_5 = all_words[index_5];
+                        uint32_t n5 = word_5.numeric;
+                        work_done_local++;
+
+                        if ((n123 & n5) != 0) {
+                            continue;
+                        }
+
+                        solutions_local++;
+                        if (search->on_solution == NULL) {
+                            continue;
+                        }
+
+                        wordle_solution_t solution = {
+                            .words = {
+                                word_1.str,
+                                word_2.str,
+                                word_3.str,
+                                word_4.str,
+                                word_5.str
+                            },
+                            .chunk = data->id,
+                            .chunk_start = data->start,
+                            .chunk_end = data->end,
+                            .score = 0
+                        };
+
+                        search->on_solution(&solution, search->user_data);
+                    }
+                }
+            }
+        }
+    }
+
+    stats->work_done += work_done_local;
+    stats->solutions += solutions_local;
+}
+
+/**
+ * Offers a solution to the best solutions found so far, and raises the score
+ * needed to make it in if it did. Solutions good enough to get here are rare,
+ * so a lock is fine, everyone else only reads the score needed.
+ *
+ * @param search The search.
+ * @param entry The solution.
+ */
+static void offer_solution(search_t *search, const topk_entry_t *entry) {
+    pthread_mutex_lock(&search->top_mutex);
+    topk_heap_push(&search->top, entry);
+    atomic_store_explicit(&search->needed, topk_heap_needed(&search->top), memory_order_relaxed);
+    pthread_mutex_unlock(&search->top_mutex);
+}
+
+/**
+ * Goes through the combinations of the chunk which could still make it into
+ * the best solutions. Same walk as `search_all`, except that before going
+ * deeper it checks whether the score so far, plus the best the remaining words
+ * could possibly add, can still reach the score needed.
+ *
+ * @param search The search.
+ * @param data The chunk.
+ * @param stats Counts the leaves checked and the solutions found.
+ */
+static void search_top(
+    search_t *search,
+    thread_arg_t *data,
+    chunk_stats_t *stats
+) {
+    word_t *all_words = search->all_words;
+    const uint64_t *bounds = search->scores->bounds;
+    unsigned long long int work_done_local = 0;
+    unsigned long long int solutions_local = 0;
+
+#define NEEDED atomic_load_explicit(&search->needed, memory_order_relaxed)
+
+// Whether `score` plus the best `remaining` words following word `index` can add falls short
+#define CANT_MAKE_IT(index, score, remaining) ( \
+    bounds[(index) * SOLUTION_WORDS + (remaining)] == NO_CHAIN || \
+    (score) + bounds[(index) * SOLUTION_WORDS + (remaining)] < NEEDED \
+)
+
+    for (int i = data->start; i < data->end; i++) {
+        word_t word_1 = all_words[i];
+        uint32_t n1 = word_1.numeric;
+        uint64_t s1 = word_1.score;
+
+        if (CANT_MAKE_IT(i, s1, 4)) {
+            continue;
+        }
+
+        for (int j = 0; j < word_1.neighbors_n; j++) {
+            int index_2 = word_1.neighbors[j];
+            word_t word_2 = all_words[index_2];
+            uint32_t n2 = word_2.numeric;
+            uint64_t s12 = s1 + word_2.score;
+
+            if (CANT_MAKE_IT(index_2, s12, 3)) {
+                continue;
+            }
+
+            for (int k = 0; k < word_2.neighbors_n; k++) {
+                int index_3 = word_2.neighbors[k];
+                word_t word_3 = all_words[index_3];
+                uint32_t n3 = word_3.numeric;
+                uint64_t s123 = s12 + word_3.score;
+
+                if ((n1 & n3) != 0) {
+                    continue;
+                }
+
+                if (CANT_MAKE_IT(index_3, s123, 2)) {
+                    continue;
+                }
+
+                uint32_t n12 = n1 | n2;
+
+                /**
+                 * Cached completions include every solution, so the scores are checked here instead.
+                 * A miss goes through the fourth and fifth words without the bounds, since only
+                 * a complete walk can be cached. That's more work per miss than below, but the
+                 * hits skip the walk altogether, which more than makes up for it.
+                 */
+                memo_entry_t completions;
+                if (search->memo.slots != NULL && find_completions(search, index_3, n12, n3, stats, &completions)) {
+                    for (int c = 0; c < completions.count; c++) {
+                        int index_4 = completions.pairs[c] >> 16;
+                        int index_5 = completions.pairs[c] & 0xFFFF;
+                        uint64_t score = s123 + all_words[index_4].score + all_words[index_5].score;
+
+                        if (index_4 <= index_3 || score < NEEDED) {
+                            continue;
+                        }
+
+                        solutions_local++;
+
+                        topk_entry_t entry = {
+                            .score = score,
+                            .words = { i, index_2, index_3, index_4, index_5 }
+                        };
+
+                        offer_solution(search, &entry);
+                    }
+                    continue;
+                }
+
+                for (int l = 0; l < word_3.neighbors_n; l++) {
+                    int index_4 = word_3.neighbors[l];
+                    word_t word_4 = all_words[index_4];
+                    uint32_t n4 = word_4.numeric;
+                    uint64_t s1234 = s123 + word_4.score;
+
+                    if ((n12 & n4) != 0) {
+                        continue;
+                    }
+
+                    if (CANT_MAKE_IT(index_4, s1234, 1)) {
+                        continue;
+                    }
+
+                    /**
+                     * The threshold only ever goes up, so a stale copy just
+                     * prunes a little less. Keeps the innermost loop from
+                     * re-reading the shared one for every leaf.
+                     */
+                    uint64_t needed = NEEDED;
+                    uint32_t n123 = n12 | n3;
+                    for (int m = 0; m < word_4.neighbors_n; m++) {
+                        int index_5 = word_4.neighbors[m];
+                        word_t word_5 = all_words[index_5];
+                        uint32_t n5 = word_5.numeric;
+                        uint64_t score = s1234 + word_5.score;
+
+                        if (score < needed) {
+                            continue;
+                        }
+
+                        work_done_local++;
+                        if ((n123 & n5) != 0) {
+                            continue;
+                        }
+
+                        solutions_local++;
+
+                        topk_entry_t entry = {
+                            .score = score,
+                            .words = { i, index_2, index_3, index_4, index_5 }
+                        };
+
+                        offer_solution(search, &entry);
+                    }
+                }
+            }
+        }
+    }
+
+#undef CANT_MAKE_IT
+#undef NEEDED
+
+    stats->work_done += work_done_local;
+    stats->solutions += solutions_local;
+}
+
+/**
+ * The thread itself. Given a thread argument, which tells the thread the range
+ * to search through and the search that range belongs to.
+ */
+static void* thread(void *arg) {
+    thread_arg_t *data = (thread_arg_t *) arg;
+    search_t *search = (search_t *) data->data;
+    chunk_stats_t stats = { 0 };
+
+    if (search->memo.slots != NULL) {
+        stats.age = memo_tick(&search->memo);
+    }
+
+    if (search->scores == NULL) {
+        search_all(search, data, &stats);
+    } else {
+        search_top(search, data, &stats);
+    }
+
+    thread_manager_t *manager = search->manager;
+    mutex_lock(manager);
+    search->work_done += stats.work_done;
+    search->solutions += stats.solutions;
+    search->memo_counters.lookups += stats.memo.lookups;
+    search->memo_counters.hits += stats.memo.hits;
+    search->memo_counters.insertions += stats.memo.insertions;
+    search->memo_counters.evictions += stats.memo.evictions;
+    bool search_done = --search->chunks_remaining == 0;
+    mutex_unlock(manager);
+
+    // Last chunk of this search, whoever started it can be told now.
+    // Nothing may touch the search after `on_done`, it may be freed.
+    if (search_done) {
+        clock_gettime(CLOCK_REALTIME, &search->finished);
+        if (search->on_done != NULL) {
+            search->on_done(search);
+        }
+    }
+
+    thread_finished(manager, data, stats.work_done);
+
+    return NULL;
+}
+
+/** The best score any solution starting in a chunk could have. */
+typedef struct {
+    int chunk;
+    uint64_t score;
+} potential_t;
+
+static int compare_potentials(const void *a, const void *b) {
+    const potential_t *potential_a = (const potential_t *) a;
+    const potential_t *potential_b = (const potential_t *) b;
+
+    // Highest first, ties in chunk order
+    if (potential_a->score != potential_b->score) {
+        return potential_a->score < potential_b->score ? 1 : -1;
+    }
+
+    return potential_a->chunk - potential_b->chunk;
+}
+
+/**
+ * Gives up on the chunks that haven't been handed out yet.
+ * Whoever finishes the last chunk that did get handed out reports the search as done,
+ * or this does if there is no such chunk.
+ *
+ * @param search The search.
+ * @param dispatched Number of chunks that were handed out.
+ * @return int Always WORDLE_ERR_THREADS.
+ */
+static int dispatch_failed(search_t *search, int dispatched) {
+    thread_manager_t *manager = search->manager;
+
+    mutex_lock(manager);
+    search->chunks_remaining -= search->total_chunks - dispatched;
+    bool search_done = search->chunks_remaining == 0;
+    mutex_unlock(manager);
+
+    if (search_done) {
+        clock_gettime(CLOCK_REALTIME, &search->finished);
+        if (search->on_done != NULL) {
+            search->on_done(search);
+        }
+    }
+
+    return WORDLE_ERR_THREADS;
+}
+
+void search_init(search_t *search, thread_manager_t *manager, word_results_t *words, int words_per_thread) {
+    search->manager = manager;
+    search->all_words = words->all_words;
+    search->word_count = words->word_count;
+    search->words_per_thread = words_per_thread;
+    search->on_solution = NULL;
+    search->user_data = NULL;
+    search->total_chunks = (int) ceil((double) words->word_count / (double) words_per_thread);
+    search->chunks_remaining = search->total_chunks;
+    search->work_done = 0;
+    search->solutions = 0;
+    search->scores = NULL;
+    search->top = (topk_heap_t) { 0 };
+    atomic_init(&search->needed, 0);
+    search->memo.slots = NULL;
+    search->memo_counters = (memo_counters_t) { 0 };
+    search->memo_bytes = 0;
+    search->chunk_order = NULL;
+    search->on_done = NULL;
+    search->data = NULL;
+}
+
+int search_init_top(search_t *search, const word_scores_t *scores, size_t k) {
+    int error = topk_heap_init(&search->top, k);
+    if (error != WORDLE_OK) {
+        return error;
+    }
+
+    // + 1 so that there's something to allocate for 0 chunks
+    search->chunk_order = (int *) calloc(search->total_chunks + 1, sizeof(int));
+    potential_t *potentials = (potential_t *) calloc(search->total_chunks + 1, sizeof(potential_t));
+    if (search->chunk_order == NULL || potentials == NULL) {
+        free(search->chunk_order);
+        free(potentials);
+        search->chunk_order = NULL;
+        topk_heap_cleanup(&search->top);
+        return WORDLE_ERR_NO_MEMORY;
+    }
+
+    if (pthread_mutex_init(&search->top_mutex, NULL) != 0) {
+        free(search->chunk_order);
+        free(potentials);
+        search->chunk_order = NULL;
+        topk_heap_cleanup(&search->top);
+        return WORDLE_ERR_THREADS;
+    }
+
+    /**
+     * Nothing can be pruned until K solutions are found, so hand out the chunks
+     * whose words could make up the best solutions first. The sooner good solutions
+     * are found, the sooner the score needed goes up.
+     */
+    for (int chunk = 0; chunk < search->total_chunks; chunk++) {
+        potentials[chunk].chunk = chunk;
+        potentials[chunk].score = 0;
+
+        int end = (chunk + 1) * search->words_per_thread;
+        for (int i = chunk * search->words_per_thread; i < end && i < search->word_count; i++) {
+            uint64_t bound = scores->bounds[i * SOLUTION_WORDS + SOLUTION_WORDS - 1];
+            if (bound != NO_CHAIN && scores->scores[i] + bound > potentials[chunk].score) {
+                potentials[chunk].score = scores->scores[i] + bound;
+            }
+        }
+    }
+
+    qsort(potentials, search->total_chunks, sizeof(potential_t), compare_potentials);
+    for (int chunk = 0; chunk < search->total_chunks; chunk++) {
+        search->chunk_order[chunk] = potentials[chunk].chunk;
+    }
+    free(potentials);
+
+    search->scores = scores;
+
+    return WORDLE_OK;
+}
+
+int search_init_memo(search_t *search, size_t entries) {
+    int error = memo_init(&search->memo, entries);
+    if (error != WORDLE_OK) {
+        return error;
+    }
+
+    search->memo_bytes = memo_bytes(&search->memo);
+
+    return WORDLE_OK;
+}
+
+void search_cleanup(search_t *search) {
+    if (search->scores != NULL) {
+        topk_heap_cleanup(&search->top);
+        pthread_mutex_destroy(&search->top_mutex);
+        free(search->chunk_order);
+        search->chunk_order = NULL;
+        search->scores = NULL;
+    }
+
+    if (search->memo.slots != NULL) {
+        memo_cleanup(&search->memo);
+    }
+}
+
+int search_dispatch(search_t *search) {
+    thread_manager_t *manager = search->manager;
+
+    clock_gettime(CLOCK_REALTIME, &search->started);
+
+    // Nothing to hand out, so nobody would ever report this search as done
+    if (search->total_chunks == 0) {
+        search->finished = search->started;
+        if (search->on_done != NULL) {
+            search->on_done(search);
+        }
+        return WORDLE_OK;
+    }
+
+    /**
+     * The whole search space is divided into chunks now, since we're using
+     * words_per_thread.
+     * Each thread gets passed a chunk to process, size of words_per_thread.
+     * So we want to process all chunks and we want to keep
+     * re-creating threads until all chunks are processed.
+     */
+    int next_chunk_index = 0;
+
+    while (next_chunk_index < search->total_chunks) {
+        // Waits for threads to become available, which on the first iteration will be
+        // immediately
+        if (mutex_wait_for_thread_availability(manager) != WORDLE_OK) {
+            return dispatch_failed(search, next_chunk_index);
+        }
+
+        /**
+         * Critical section. Creating new threads and updating the thread count.
+         * Create as many threads as possible on this iteration.
+         * 
+         * On the first iteration, max_threads will be created, on every next iteration
+         * we'll see. Probably only 1 thread at a time, but perhaps more.
+         */
+        for (int i = manager->thread_count; i < manager->max_threads; i++) {
+            int chunk = search->chunk_order != NULL
+                ? search->chunk_order[next_chunk_index]
+                : next_chunk_index;
+
+            // Worked out as int, the 16 bit fields only take it once it's clamped to the word count
+            int start = chunk * search->words_per_thread;
+            int end = search->word_count - start > search->words_per_thread
+                ? start + search->words_per_thread
+                : search->word_count; // Last chunk
+
+            thread_arg_t arg = {
+                .id = chunk,
+                // .running should be here but create_thread does it for us
+                .start = start,
+                .end = end,
+                .data = search
+            };
+
+            if (create_thread(manager, arg, thread) != WORDLE_OK) {
+                mutex_unlock(manager);
+                return dispatch_failed(search, next_chunk_index);
+            }
+            next_chunk_index++;
+
+            if (next_chunk_index == search->total_chunks) {
+                break;
+            }
+        }
+
+        mutex_unlock(manager);
+    }
+
+    return WORDLE_OK;
+}
+
+double search_elapsed_ms(const search_t *search) {
+    double start = search->started.tv_sec * 1E9 + search->started.tv_nsec;
+    double end = search->finished.tv_sec * 1E9 + search->finished.tv_nsec;
+
+    return (end - start) / 1E6;
+}
@@ -0,0 +1,169 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "../words/words.h"
+#include "../threads/threads.h"
+#include "../topk/topk.h"
+#include "../memo/memo.h"
+#include <time.h>
+#include <stdatomic.h>
+
+typedef struct search search_t;
+
+/**
+ * Called once all chunks of a search have been processed.
+ * Runs on the thread that finished the last chunk.
+ */
+typedef void (*search_done_t)(search_t *search);
+
+/**
+ * A single search through one set of words.
+ *
+ * The search is divided into chunks which are handed out to the threads
+ * of a thread manager, which may be shared so that several searches can
+ * be in flight at the same time.
+ */
+struct search {
+    /** Threads to run the chunks on. */
+    thread_manager_t *manager;
+
+    /** Words to search through, sorted and with their neighbors built. */
+    word_t *all_words;
+
+    /** Word count. */
+    int word_count;
+
+    /** Number of words each thread should try for the first position. */
+    int words_per_thread;
+
+    /** Called for every solution, NULL to only count them. */
+    wordle_callback_t on_solution;
+
+    /** Passed to `on_solution`. */
+    void *user_data;
+
+    /** Scores and bounds when only the best solutions are wanted, NULL to find all of them. */
+    const word_scores_t *scores;
+
+    /** The best solutions found so far. Protected by `top_mutex`. */
+    topk_heap_t top;
+
+    /** Protects `top`. */
+    pthread_mutex_t top_mutex;
+
+    /**
+     * Lowest score a solution needs to make it into the best ones, a copy of
+     * the K-th best score once there are K. Read without locking before going
+     * deeper into the search, only ever raised.
+     */
+    _Atomic uint64_t needed;
+
+    /** Completions of the first three words shared by all chunks, `slots` is NULL when not caching. */
+    memo_t memo;
+
+    /**
+     * How the cache did, added up over the chunks.
+     * Protected by the manager's mutex.
+     */
+    memo_counters_t memo_counters;
+
+    /** Bytes used by the cache, kept after it's freed. */
+    size_t memo_bytes;
+
+    /** Order to hand out the chunks in, NULL for first to last. */
+    int *chunk_order;
+
+    /** Total number of chunks this search was divided into. */
+    int total_chunks;
+
+    /**
+     * Chunks that haven't finished yet.
+     * Protected by the manager's mutex.
+     */
+    int chunks_remaining;
+
+    /**
+     * Five-word combination leaves checked by this search.
+     * Protected by the manager's mutex.
+     */
+    unsigned long long int work_done;
+
+    /**
+     * Solutions found by this search.
+     * Protected by the manager's mutex.
+     */
+    unsigned long long int solutions;
+
+    /** When the first chunk was handed out. */
+    struct timespec started;
+
+    /** When the last chunk finished. */
+    struct timespec finished;
+
+    /** Optional, called once the whole search is done. */
+    search_done_t on_done;
+
+    /** Whatever the caller wants to associate with the search. */
+    void *data;
+};
+
+/**
+ * Initializes a search.
+ *
+ * @param search The search.
+ * @param manager Threads to run the chunks on.
+ * @param words Words to search through.
+ * @param words_per_thread Number of words each thread should try for the first position.
+ */
+void search_init(search_t *search, thread_manager_t *manager, word_results_t *words, int words_per_thread);
+
+/**
+ * Makes the search only keep the `k` best scoring solutions, instead of
+ * reporting every solution to `on_solution`.
+ *
+ * @param search An initialized search.
+ * @param scores Scores and bounds matching the search's words and their order.
+ * @param k How many solutions to keep.
+ * @return int wordle_error_t
+ */
+int search_init_top(search_t *search, const word_scores_t *scores, size_t k);
+
+/**
+ * Makes the search cache the ways to finish a solution for every set of
+ * letters the first three words use, so that they're only found once.
+ *
+ * @param search An initialized search.
+ * @param entries How many entries the cache can hold.
+ * @return int wordle_error_t
+ */
+int search_init_memo(search_t *search, size_t entries);
+
+/**
+ * Cleanup. Fine to call after a failed `search_init_top` or `search_init_memo`.
+ *
+ * @param search The search.
+ */
+void search_cleanup(search_t *search);
+
+/**
+ * Hands out all chunks of the search to the threads of its manager.
+ * Returns as soon as the last chunk has been handed out, which means
+ * the search may still be running. Use `on_done` to find out when it's done.
+ *
+ * The `search` must stay alive until it's done. `on_done` is called even if
+ * handing out the chunks fails, once the chunks that did get handed out are done.
+ *
+ * @param search The search.
+ * @return int wordle_error_t
+ */
+int search_dispatch(search_t *search);
+
+/**
+ * Milliseconds between the first chunk being handed out and the last one finishing.
+ *
+ * @param search A finished search.
+ * @return double
+ */
+double search_elapsed_ms(const search_t *search);
+
+#endif
@@ -2,109 +2,137 @@
 #include <stdio.h>
 #include <string.h>
 
-/** The thread manager. */
-thread_manager_t thread_manager;
-
-void mutex_lock() {
-    if (pthread_mutex_lock(&thread_manager.mutex) == -1) {
-        perror("pthread_mutex_lock");
-        exit(EXIT_FAILURE);
+int mutex_lock(thread_manager_t *manager) {
+    if (pthread_mutex_lock(&manager->mutex) != 0) {
+        return WORDLE_ERR_THREADS;
     }
+
+    return WORDLE_OK;
 }
 
-void mutex_unlock() {
-    if (pthread_mutex_unlock(&thread_manager.mutex) == -1) {
-        perror("pthread_mutex_unlock");
-        exit(EXIT_FAILURE);
+int mutex_unlock(thread_manager_t *manager) {
+    if (pthread_mutex_unlock(&manager->mutex) != 0) {
+        return WORDLE_ERR_THREADS;
     }
+
+    return WORDLE_OK;
 }
 
-void thread_manager_init(int max_threads) {
-    thread_manager.thread_count = 0;
-    thread_manager.max_threads = max_threads;
-    thread_manager.work_done = 0;
-    thread_manager.thread_args = (thread_arg_t *) calloc(max_threads, sizeof(thread_arg_t));
-    if (thread_manager.thread_args == NULL) {
-        perror("calloc");
-        exit(EXIT_FAILURE);
+int thread_manager_init(thread_manager_t *manager, int max_threads) {
+    if (max_threads <= 0 || max_threads > UINT16_MAX) {
+        return WORDLE_ERR_ARGS;
     }
-    memset(thread_manager.thread_args, 0, max_threads * sizeof(thread_arg_t));
 
-    if (pthread_mutex_init(&thread_manager.mutex, NULL) == -1) {
-        perror("pthread_mutex_init");
-        exit(EXIT_FAILURE);
+    manager->thread_count = 0;
+    manager->max_threads = max_threads;
+    manager->work_done = 0;
+    manager->thread_args = (thread_arg_t *) calloc(max_threads, sizeof(thread_arg_t));
+    if (manager->thread_args == NULL) {
+        return WORDLE_ERR_NO_MEMORY;
     }
+    memset(manager->thread_args, 0, max_threads * sizeof(thread_arg_t));
 
-    if (pthread_cond_init(&thread_manager.can_create_thread, NULL)) {
-        perror("pthread_cond_init");
-        exit(EXIT_FAILURE);
+    if (pthread_mutex_init(&manager->mutex, NULL) != 0) {
+        free(manager->thread_args);
+        return WORDLE_ERR_THREADS;
     }
 
-    if (pthread_cond_init(&thread_manager.all_threads_finished, NULL)) {
-        perror("pthread_cond_init");
-        exit(EXIT_FAILURE);
+    if (pthread_cond_init(&manager->can_create_thread, NULL) != 0) {
+        pthread_mutex_destroy(&manager->mutex);
+        free(manager->thread_args);
+        return WORDLE_ERR_THREADS;
     }
-}
-
-void thread_manager_cleanup() {
-    free(thread_manager.thread_args);
 
-    if (pthread_mutex_destroy(&thread_manager.mutex) == -1) {
-        perror("pthread_mutex_destroy");
-        exit(EXIT_FAILURE);
+    if (pthread_cond_init(&manager->all_threads_finished, NULL) != 0) {
+        pthread_cond_destroy(&manager->can_create_thread);
+        pthread_mutex_destroy(&manager->mutex);
+        free(manager->thread_args);
+        return WORDLE_ERR_THREADS;
     }
 
-    if (pthread_cond_destroy(&thread_manager.can_create_thread) == -1) {
-        perror("pthread_cond_destroy");
-        exit(EXIT_FAILURE);
-    }
+    return WORDLE_OK;
+}
 
-    if (pthread_cond_destroy(&thread_manager.all_threads_finished) == -1) {
-        perror("pthread_cond_destroy");
-        exit(EXIT_FAILURE);
-    }
+void thread_manager_cleanup(thread_manager_t *manager) {
+    free(manager->thread_args);
+    pthread_mutex_destroy(&manager->mutex);
+    pthread_cond_destroy(&manager->can_create_thread);
+    pthread_cond_destroy(&manager->all_threads_finished);
 }
 
-pthread_t create_thread(thread_arg_t arg, void *thread(void *)) {
+int create_thread(thread_manager_t *manager, thread_arg_t arg, void *thread(void *)) {
     // Some thread finished, we can use this part of the heap now.
     thread_arg_t *free_thread_arg = NULL;
-    for (int i = 0; i < thread_manager.max_threads; i++) {
+    for (int i = 0; i < manager->max_threads; i++) {
         // Is your thread running? Well you beter catch it then :)
-        if (!thread_manager.thread_args[i].running) {
-            free_thread_arg = &(thread_manager.thread_args[i]);
+        if (!manager->thread_args[i].running) {
+            free_thread_arg = &(manager->thread_args[i]);
             break;
         }
     }
 
+    // Could not find space for a thread
     if (free_thread_arg == NULL) {
-        printf("Could not find space for a thread\n");
-        exit(EXIT_FAILURE);
+        return WORDLE_ERR_THREADS;
     }
 
     // Before copying into the heap, mark it as running
     arg.running = true;
     memcpy(free_thread_arg, &arg, sizeof(thread_arg_t));
-    thread_manager.thread_count++;
 
     pthread_t tid;
-    if (pthread_create(&tid, NULL, thread, free_thread_arg) == -1) {
-        perror("pthread_create");
-        exit(EXIT_FAILURE);
+    if (pthread_create(&tid, NULL, thread, free_thread_arg) != 0) {
+        free_thread_arg->running = false;
+        return WORDLE_ERR_THREADS;
     }
 
-    return tid;
+    manager->thread_count++;
+
+    // Nobody joins these threads, so let them clean up after themselves.
+    // Otherwise every finished chunk would leak its stack, which adds up
+    // quickly when running through many dictionaries.
+    pthread_detach(tid);
+
+    return WORDLE_OK;
 }
 
-void mutex_wait_for_thread_availability() {
-    mutex_lock();
-    while (thread_manager.thread_count == thread_manager.max_threads) {
-        pthread_cond_wait(&thread_manager.can_create_thread, &thread_manager.mutex);
+void thread_finished(thread_manager_t *manager, thread_arg_t *arg, unsigned long long int work_done) {
+    // Nothing sensible to do if this fails, the thread is exiting either way
+    mutex_lock(manager);
+    // Several searches may be waiting to hand out chunks on a shared pool,
+    // so wake one of them up for every slot that frees up.
+    pthread_cond_signal(&manager->can_create_thread);
+
+    manager->thread_count--;
+    manager->work_done += work_done;
+    arg->running = false;
+
+    if (manager->thread_count == 0) {
+        pthread_cond_broadcast(&manager->all_threads_finished);
+    }
+    mutex_unlock(manager);
+}
+
+int mutex_wait_for_thread_availability(thread_manager_t *manager) {
+    if (mutex_lock(manager) != WORDLE_OK) {
+        return WORDLE_ERR_THREADS;
+    }
+
+    while (manager->thread_count == manager->max_threads) {
+        pthread_cond_wait(&manager->can_create_thread, &manager->mutex);
     }
+
+    return WORDLE_OK;
 }
 
-void mutex_wait_for_all_threads_to_finish() {
-    mutex_lock();
-    while (thread_manager.thread_count != 0) {
-        pthread_cond_wait(&thread_manager.all_threads_finished, &thread_manager.mutex);
+int mutex_wait_for_all_threads_to_finish(thread_manager_t *manager) {
+    if (mutex_lock(manager) != WORDLE_OK) {
+        return WORDLE_ERR_THREADS;
     }
+
+    while (manager->thread_count != 0) {
+        pthread_cond_wait(&manager->all_threads_finished, &manager->mutex);
+    }
+
+    return WORDLE_OK;
 }
@@ -1,7 +1,11 @@
+#ifndef THREADS_H
+#define THREADS_H
+
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include "../wordle/wordle.h"
 
 /** An argument passed to a thread. */
 typedef struct {
@@ -18,6 +22,12 @@ typedef struct {
 
     /** Index of the last word thread should try for the first position. */
     uint16_t end;
+
+    /**
+     * Whatever the thread is working on, e.g. the search this chunk belongs to.
+     * Lets several jobs share the same set of threads.
+     */
+    void *data;
 } thread_arg_t;
 
 /** Helps manage threads easier. */
@@ -48,41 +58,69 @@ typedef struct {
     pthread_mutex_t mutex;
 } thread_manager_t;
 
-/** Locks the thread_manager mutex. */
-void mutex_lock();
+/** Locks the manager's mutex. */
+int mutex_lock(thread_manager_t *manager);
 
-/** Unlocks the thread_manager mutex. */
-void mutex_unlock();
+/** Unlocks the manager's mutex. */
+int mutex_unlock(thread_manager_t *manager);
 
 /**
- * Initializes the thread_manager. 
+ * Initializes a thread manager. 
  * 
+ * @param manager The manager.
  * @param max_threads Maximum number of threads.
+ * @return int wordle_error_t
  */
-void thread_manager_init(int max_threads);
+int thread_manager_init(thread_manager_t *manager, int max_threads);
 
 /**
  * Cleanup.
+ *
+ * @param manager The manager.
  */
-void thread_manager_cleanup();
+void thread_manager_cleanup(thread_manager_t *manager);
 
 /**
  * Creates a thread. MUST BE CALLED after acquiring a mutex lock
- * since this function operates on the shared `thread_manager` variable.
+ * since this function operates on the shared manager.
  * 
+ * @param manager The manager.
  * @param arg Argument to be passed to the thread. Will be copied to the heap.
  * @param thread A function pointer for the thread to execute.
- * @return pthread_t
+ * @return int wordle_error_t
  */
-pthread_t create_thread(thread_arg_t arg, void *thread(void *));
+int create_thread(thread_manager_t *manager, thread_arg_t arg, void *thread(void *));
+
+/**
+ * Must be called by every thread created with `create_thread` as its very last
+ * action. Frees up the thread's slot, logs its work done and wakes up
+ * whoever is waiting for a thread to become available.
+ *
+ * Acquires and releases the mutex lock itself. `arg` must not be touched
+ * after this call, since it may already be reused by a new thread.
+ *
+ * @param manager The manager.
+ * @param arg The argument the thread was created with.
+ * @param work_done Work done by the thread.
+ */
+void thread_finished(thread_manager_t *manager, thread_arg_t *arg, unsigned long long int work_done);
 
 /**
  * Awaits until another thread can be created.
  * This method acquires but doesn't release a mutex lock.
+ *
+ * @param manager The manager.
+ * @return int wordle_error_t
  */
-void mutex_wait_for_thread_availability();
+int mutex_wait_for_thread_availability(thread_manager_t *manager);
 
 /**
  * Waits for all threads to finish.
+ * This method acquires but doesn't release a mutex lock.
+ *
+ * @param manager The manager.
+ * @return int wordle_error_t
  */
-void mutex_wait_for_all_threads_to_finish();
+int mutex_wait_for_all_threads_to_finish(thread_manager_t *manager);
+
+#endif
@@ -0,0 +1,222 @@
+#include "topk.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Names of the score models, indexed by `wordle_score_t`. */
+static const char *score_names[WORDLE_SCORE_COUNT] = {
+    [WORDLE_SCORE_FREQUENCY] = "frequency",
+    [WORDLE_SCORE_LETTERS] = "letters"
+};
+
+/**
+ * Whether entry `a` ranks below entry `b`.
+ * Ties in score are broken by the word indexes, so the K best are always the same K.
+ */
+static bool entry_worse(const topk_entry_t *a, const topk_entry_t *b) {
+    if (a->score != b->score) {
+        return a->score < b->score;
+    }
+
+    return memcmp(a->words, b->words, sizeof(a->words)) > 0;
+}
+
+static int compare_entries(const void *a, const void *b) {
+    const topk_entry_t *entry_a = (const topk_entry_t *) a;
+    const topk_entry_t *entry_b = (const topk_entry_t *) b;
+
+    // Best first
+    if (entry_worse(entry_a, entry_b)) {
+        return 1;
+    }
+
+    return entry_worse(entry_b, entry_a) ? -1 : 0;
+}
+
+/**
+ * Restores the heap property downwards from `i`.
+ *
+ * @param heap The heap.
+ * @param i Index of the entry that may be out of place.
+ */
+static void sift_down(topk_heap_t *heap, size_t i) {
+    topk_entry_t *entries = heap->entries;
+
+    while (true) {
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        size_t worst = i;
+
+        if (left < heap->count && entry_worse(&entries[left], &entries[worst])) {
+            worst = left;
+        }
+
+        if (right < heap->count && entry_worse(&entries[right], &entries[worst])) {
+            worst = right;
+        }
+
+        if (worst == i) {
+            return;
+        }
+
+        topk_entry_t tmp = entries[i];
+        entries[i] = entries[worst];
+        entries[worst] = tmp;
+        i = worst;
+    }
+}
+
+const char* wordle_score_name(wordle_score_t score) {
+    return score >= 0 && score < WORDLE_SCORE_COUNT ? score_names[score] : "unknown";
+}
+
+wordle_score_t wordle_parse_score(const char *name) {
+    for (int i = 0; i < WORDLE_SCORE_COUNT; i++) {
+        if (strcmp(name, score_names[i]) == 0) {
+            return (wordle_score_t) i;
+        }
+    }
+
+    return WORDLE_SCORE_COUNT;
+}
+
+int score_words(word_results_t *results, wordle_score_t model, word_scores_t *scores) {
+    word_t *words = results->all_words;
+    int total = results->word_count;
+
+    // + 1 so that there's something to allocate for 0 words
+    scores->scores = (uint64_t *) calloc(total + 1, sizeof(uint64_t));
+    scores->bounds = (uint64_t *) calloc((total + 1) * SOLUTION_WORDS, sizeof(uint64_t));
+    if (scores->scores == NULL || scores->bounds == NULL) {
+        cleanup_scores(scores);
+        return WORDLE_ERR_NO_MEMORY;
+    }
+
+    switch (model) {
+        case WORDLE_SCORE_LETTERS: {
+            // How many words use each letter
+            uint64_t letter_counts[26] = { 0 };
+            for (int i = 0; i < total; i++) {
+                for (int c = 0; c < 26; c++) {
+                    if (words[i].numeric & (1 << c)) {
+                        letter_counts[c]++;
+                    }
+                }
+            }
+
+            // Words made of common letters score higher
+            for (int i = 0; i < total; i++) {
+                for (int c = 0; c < 26; c++) {
+                    if (words[i].numeric & (1 << c)) {
+                        scores->scores[i] += letter_counts[c];
+                    }
+                }
+            }
+            break;
+        }
+
+        case WORDLE_SCORE_FREQUENCY:
+        default:
+            for (int i = 0; i < total; i++) {
+                scores->scores[i] = words[i].frequency;
+            }
+            break;
+    }
+
+    // Frequencies are 32-bit and letter scores are far smaller, so these always fit
+    for (int i = 0; i < total; i++) {
+        words[i].score = (uint32_t) scores->scores[i];
+    }
+
+    /**
+     * Neighbors always come after the word, so going backwards
+     * every neighbor's bounds are known by the time they're needed.
+     */
+    for (int i = total - 1; i >= 0; i--) {
+        uint64_t *bounds = &scores->bounds[i * SOLUTION_WORDS];
+        bounds[0] = 0;
+
+        for (int r = 1; r < SOLUTION_WORDS; r++) {
+            bounds[r] = NO_CHAIN;
+
+            for (int j = 0; j < words[i].neighbors_n; j++) {
+                int neighbor = words[i].neighbors[j];
+                uint64_t rest = scores->bounds[neighbor * SOLUTION_WORDS + r - 1];
+                if (rest == NO_CHAIN) {
+                    continue;
+                }
+
+                uint64_t chain = scores->scores[neighbor] + rest;
+                if (bounds[r] == NO_CHAIN || chain > bounds[r]) {
+                    bounds[r] = chain;
+                }
+            }
+        }
+    }
+
+    return WORDLE_OK;
+}
+
+void cleanup_scores(word_scores_t *scores) {
+    free(scores->scores);
+    free(scores->bounds);
+    scores->scores = NULL;
+    scores->bounds = NULL;
+}
+
+int topk_heap_init(topk_heap_t *heap, size_t capacity) {
+    heap->count = 0;
+    heap->capacity = capacity;
+    heap->entries = (topk_entry_t *) calloc(capacity, sizeof(topk_entry_t));
+    if (heap->entries == NULL) {
+        return WORDLE_ERR_NO_MEMORY;
+    }
+
+    return WORDLE_OK;
+}
+
+void topk_heap_cleanup(topk_heap_t *heap) {
+    free(heap->entries);
+    heap->entries = NULL;
+    heap->count = 0;
+}
+
+void topk_heap_push(topk_heap_t *heap, const topk_entry_t *entry) {
+    topk_entry_t *entries = heap->entries;
+
+    if (heap->count < heap->capacity) {
+        // Sift up
+        size_t i = heap->count++;
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!entry_worse(entry, &entries[parent])) {
+                break;
+            }
+
+            entries[i] = entries[parent];
+            i = parent;
+        }
+
+        entries[i] = *entry;
+        return;
+    }
+
+    // Full, replace the worst one if this is better
+    if (!entry_worse(&entries[0], entry)) {
+        return;
+    }
+
+    entries[0] = *entry;
+    sift_down(heap, 0);
+}
+
+uint64_t topk_heap_needed(const topk_heap_t *heap) {
+    if (heap->count < heap->capacity) {
+        return 0;
+    }
+
+    return heap->entries[0].score;
+}
+
+void topk_heap_sort(topk_heap_t *heap) {
+    qsort(heap->entries, heap->count, sizeof(topk_entry_t), compare_entries);
+}
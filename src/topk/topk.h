@@ -0,0 +1,108 @@
+#ifndef TOPK_H
+#define TOPK_H
+
+#include "../words/words.h"
+#include <stddef.h>
+
+/**
+ * Marks a word that isn't followed by a chain of that many non-overlapping words
+ * in the search graph, so it can't be at that position of a solution at all.
+ */
+#define NO_CHAIN UINT64_MAX
+
+/** Number of words in a solution. */
+#define SOLUTION_WORDS 5
+
+/** A scored solution. */
+typedef struct {
+    /** Sum of the scores of the words. */
+    uint64_t score;
+
+    /** Indexes of the words. */
+    uint16_t words[SOLUTION_WORDS];
+} topk_entry_t;
+
+/** Keeps the K best entries seen, as a min-heap. */
+typedef struct {
+    topk_entry_t *entries;
+
+    /** Number of entries stored. */
+    size_t count;
+
+    /** K. */
+    size_t capacity;
+} topk_heap_t;
+
+/**
+ * Per-word scores, and upper bounds for how much the words after each word can add.
+ *
+ * Only forward edges are stored, so every solution is a chain of words,
+ * each one a neighbor of the one before. `bounds[i * SOLUTION_WORDS + r]`
+ * is the highest score of any chain of `r` words following word `i`, or NO_CHAIN
+ * if there is no such chain. The words of a real solution also can't overlap
+ * with the words before their predecessor, so this never underestimates.
+ */
+typedef struct {
+    uint64_t *scores;
+    uint64_t *bounds;
+} word_scores_t;
+
+/**
+ * Scores the words, storing each in its `word_t` too, and calculates the bounds.
+ * Has to be redone whenever the words are re-ordered.
+ *
+ * @param words Loaded words.
+ * @param model How to score the words.
+ * @param scores Filled in with the scores.
+ * @return int wordle_error_t
+ */
+int score_words(word_results_t *words, wordle_score_t model, word_scores_t *scores);
+
+/**
+ * Cleanup.
+ *
+ * @param scores The scores, may be empty.
+ */
+void cleanup_scores(word_scores_t *scores);
+
+/**
+ * Initializes a heap.
+ *
+ * @param heap The heap.
+ * @param capacity K.
+ * @return int wordle_error_t
+ */
+int topk_heap_init(topk_heap_t *heap, size_t capacity);
+
+/**
+ * Cleanup.
+ *
+ * @param heap The heap.
+ */
+void topk_heap_cleanup(topk_heap_t *heap);
+
+/**
+ * Offers an entry to the heap, kept if it's among the K best so far.
+ *
+ * @param heap The heap.
+ * @param entry The entry.
+ */
+void topk_heap_push(topk_heap_t *heap, const topk_entry_t *entry);
+
+/**
+ * Lowest score an entry needs to be kept by the heap. 0 until the heap is full.
+ *
+ * @param heap The heap.
+ * @return uint64_t
+ */
+uint64_t topk_heap_needed(const topk_heap_t *heap);
+
+/**
+ * Sorts the entries from the best to the worst. The heap is no longer
+ * a heap afterwards, only `entries` and `count` may be used.
+ *
+ * @param heap The heap.
+ */
+void topk_heap_sort(topk_heap_t *heap);
+
+#endif
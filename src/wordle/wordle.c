@@ -0,0 +1,467 @@
+#include "wordle.h"
+#include "../words/words.h"
+#include "../threads/threads.h"
+#include "../search/search.h"
+#include "../topk/topk.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/**
+ * Default options.
+ *
+ * These values are determined from the `time.js` / `time.txt` output.
+ * These work the best for my 8 core machine.
+ */
+#define DEFAULT_MAX_THREADS 8
+#define DEFAULT_WORDS_PER_THREAD 10
+
+/** About as many as there are different sets of letters for the first three words of the standard list. */
+#define DEFAULT_CACHE_ENTRIES (1 << 20)
+
+/**
+ * The cache never gets more entries than this per word, so that small lists
+ * get a small cache. The standard list has about 230 sets of letters for the
+ * first three words per word, fewer words share fewer letters.
+ */
+#define CACHE_ENTRIES_PER_WORD 256
+
+struct wordle_pool {
+    thread_manager_t manager;
+};
+
+struct wordle {
+    wordle_options_t options;
+
+    /** Pool the search runs on, either shared or `owned_pool`. */
+    wordle_pool_t *pool;
+
+    /** The context's own pool, if it wasn't given one. */
+    wordle_pool_t *owned_pool;
+
+    /** Loaded words, `all_words` is NULL until something is loaded. */
+    word_results_t words;
+
+    /** Milliseconds spent loading, or re-ordering, the words. */
+    double load_ms;
+
+    /** Scores and bounds of the words, only when `top_k` is set. */
+    word_scores_t scores;
+
+    /** The current or last search. */
+    search_t search;
+
+    /** Whether a solve was started and hasn't been waited for yet. */
+    bool solving;
+
+    /** Whether the current search is done. Protected by `mutex`. */
+    bool search_done;
+
+    /** Protects `search_done`. */
+    pthread_mutex_t mutex;
+
+    /** Signals when the current search is done. */
+    pthread_cond_t search_finished;
+};
+
+/** Where `wordle_solve_buffer` stores the solutions. */
+typedef struct {
+    wordle_solution_t *solutions;
+    size_t capacity;
+    atomic_size_t count;
+} solution_buffer_t;
+
+static const char *error_messages[] = {
+    [WORDLE_OK] = "no error",
+    [WORDLE_ERR_ARGS] = "invalid argument",
+    [WORDLE_ERR_IO] = "could not read the words file",
+    [WORDLE_ERR_NO_MEMORY] = "out of memory",
+    [WORDLE_ERR_HASHMAP_FULL] = "too many distinct words for the anagram hashmap",
+    [WORDLE_ERR_TOO_MANY_WORDS] = "too many words",
+    [WORDLE_ERR_THREADS] = "could not create or synchronize threads",
+    [WORDLE_ERR_NOT_LOADED] = "no words loaded",
+    [WORDLE_ERR_BUSY] = "already solving"
+};
+
+static double elapsed_ms(struct timespec *start, struct timespec *end) {
+    return ((end->tv_sec * 1E9 + end->tv_nsec) - (start->tv_sec * 1E9 + start->tv_nsec)) / 1E6;
+}
+
+/**
+ * Scores the words for the top-K search, if there is one.
+ * The bounds depend on the order, so this has to follow every (re-)ordering.
+ */
+static int rescore(wordle_t *wordle) {
+    cleanup_scores(&wordle->scores);
+
+    if (wordle->options.top_k == 0) {
+        return WORDLE_OK;
+    }
+
+    return score_words(&wordle->words, wordle->options.score, &wordle->scores);
+}
+
+/** Called by whichever thread finished the last chunk of the search. */
+static void search_done(search_t *search) {
+    wordle_t *wordle = (wordle_t *) search->data;
+
+    pthread_mutex_lock(&wordle->mutex);
+    wordle->search_done = true;
+    pthread_cond_broadcast(&wordle->search_finished);
+    pthread_mutex_unlock(&wordle->mutex);
+}
+
+/** Stores a solution in the `solution_buffer_t` passed as user data. */
+static void store_solution(const wordle_solution_t *solution, void *user_data) {
+    solution_buffer_t *buffer = (solution_buffer_t *) user_data;
+
+    size_t index = atomic_fetch_add(&buffer->count, 1);
+    if (index < buffer->capacity) {
+        buffer->solutions[index] = *solution;
+    }
+}
+
+void wordle_options_init(wordle_options_t *options) {
+    options->max_threads = DEFAULT_MAX_THREADS;
+    options->words_per_thread = DEFAULT_WORDS_PER_THREAD;
+    options->order = WORDLE_ORDER_NUMERIC;
+    options->top_k = 0;
+    options->score = WORDLE_SCORE_FREQUENCY;
+    options->cache_entries = DEFAULT_CACHE_ENTRIES;
+    options->pool = NULL;
+}
+
+const char* wordle_strerror(int error) {
+    if (error < 0 || error >= (int) (sizeof(error_messages) / sizeof(error_messages[0]))) {
+        return "unknown error";
+    }
+
+    return error_messages[error];
+}
+
+int wordle_pool_create(wordle_pool_t **pool, int max_threads) {
+    *pool = (wordle_pool_t *) calloc(1, sizeof(wordle_pool_t));
+    if (*pool == NULL) {
+        return WORDLE_ERR_NO_MEMORY;
+    }
+
+    int error = thread_manager_init(&(*pool)->manager, max_threads);
+    if (error != WORDLE_OK) {
+        free(*pool);
+        *pool = NULL;
+    }
+
+    return error;
+}
+
+void wordle_pool_destroy(wordle_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    // Threads may still be on their way out after reporting their search as done
+    if (mutex_wait_for_all_threads_to_finish(&pool->manager) == WORDLE_OK) {
+        mutex_unlock(&pool->manager);
+    }
+
+    thread_manager_cleanup(&pool->manager);
+    free(pool);
+}
+
+unsigned long long int wordle_pool_leaves(wordle_pool_t *pool) {
+    unsigned long long int leaves = 0;
+
+    if (mutex_lock(&pool->manager) == WORDLE_OK) {
+        leaves = pool->manager.work_done;
+        mutex_unlock(&pool->manager);
+    }
+
+    return leaves;
+}
+
+int wordle_create(wordle_t **wordle, const wordle_options_t *options) {
+    wordle_options_t defaults;
+    if (options == NULL) {
+        wordle_options_init(&defaults);
+        options = &defaults;
+    }
+
+    if (options->words_per_thread <= 0 || options->order < 0 || options->order >= WORDLE_ORDER_COUNT) {
+        return WORDLE_ERR_ARGS;
+    }
+
+    if (options->score < 0 || options->score >= WORDLE_SCORE_COUNT) {
+        return WORDLE_ERR_ARGS;
+    }
+
+    wordle_t *context = (wordle_t *) calloc(1, sizeof(wordle_t));
+    if (context == NULL) {
+        return WORDLE_ERR_NO_MEMORY;
+    }
+
+    context->options = *options;
+    context->pool = options->pool;
+
+    if (context->pool == NULL) {
+        int error = wordle_pool_create(&context->owned_pool, options->max_threads);
+        if (error != WORDLE_OK) {
+            free(context);
+            return error;
+        }
+
+        context->pool = context->owned_pool;
+    }
+
+    if (pthread_mutex_init(&context->mutex, NULL) != 0) {
+        wordle_pool_destroy(context->owned_pool);
+        free(context);
+        return WORDLE_ERR_THREADS;
+    }
+
+    if (pthread_cond_init(&context->search_finished, NULL) != 0) {
+        pthread_mutex_destroy(&context->mutex);
+        wordle_pool_destroy(context->owned_pool);
+        free(context);
+        return WORDLE_ERR_THREADS;
+    }
+
+    *wordle = context;
+
+    return WORDLE_OK;
+}
+
+int wordle_load(wordle_t *wordle, const char *filename) {
+    if (wordle->solving) {
+        return WORDLE_ERR_BUSY;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_REALTIME, &start);
+
+    word_results_t words;
+    int error = load_words(filename, wordle->options.order, &words);
+    if (error != WORDLE_OK) {
+        return error;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &end);
+
+    if (wordle->words.all_words != NULL) {
+        cleanup_words(wordle->words.all_words, wordle->words.word_count);
+    }
+
+    wordle->words = words;
+    wordle->load_ms = elapsed_ms(&start, &end);
+    memset(&wordle->search, 0, sizeof(search_t));
+
+    return rescore(wordle);
+}
+
+int wordle_set_order(wordle_t *wordle, wordle_order_t order) {
+    if (wordle->solving) {
+        return WORDLE_ERR_BUSY;
+    }
+
+    if (order < 0 || order >= WORDLE_ORDER_COUNT) {
+        return WORDLE_ERR_ARGS;
+    }
+
+    if (wordle->words.all_words == NULL) {
+        return WORDLE_ERR_NOT_LOADED;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_REALTIME, &start);
+
+    // Leaves the words in the old order if it fails
+    int error = order_words(&wordle->words, order);
+    if (error != WORDLE_OK) {
+        return error;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &end);
+
+    wordle->options.order = order;
+    wordle->load_ms = elapsed_ms(&start, &end);
+
+    // The words can still be searched through if this fails, only not for the best solutions
+    return rescore(wordle);
+}
+
+int wordle_set_cache(wordle_t *wordle, size_t entries) {
+    if (wordle->solving) {
+        return WORDLE_ERR_BUSY;
+    }
+
+    wordle->options.cache_entries = entries;
+
+    return WORDLE_OK;
+}
+
+int wordle_solve_start(wordle_t *wordle, wordle_callback_t callback, void *user_data) {
+    if (wordle->solving) {
+        return WORDLE_ERR_BUSY;
+    }
+
+    if (wordle->words.all_words == NULL) {
+        return WORDLE_ERR_NOT_LOADED;
+    }
+
+    search_t *search = &wordle->search;
+    search_init(search, &wordle->pool->manager, &wordle->words, wordle->options.words_per_thread);
+    search->on_solution = callback;
+    search->user_data = user_data;
+    search->on_done = search_done;
+    search->data = wordle;
+
+    if (wordle->options.top_k > 0) {
+        if (wordle->scores.scores == NULL) {
+            // Scoring failed when loading
+            return WORDLE_ERR_NO_MEMORY;
+        }
+
+        int error = search_init_top(search, &wordle->scores, wordle->options.top_k);
+        if (error != WORDLE_OK) {
+            return error;
+        }
+    }
+
+    size_t cache_entries = (size_t) wordle->words.word_count * CACHE_ENTRIES_PER_WORD;
+    if (cache_entries > wordle->options.cache_entries) {
+        cache_entries = wordle->options.cache_entries;
+    }
+
+    if (cache_entries > 0) {
+        int error = search_init_memo(search, cache_entries);
+        if (error != WORDLE_OK) {
+            search_cleanup(search);
+            return error;
+        }
+    }
+
+    wordle->search_done = false;
+    wordle->solving = true;
+
+    // Even if this fails, the search reports itself as done once
+    // the chunks that did get handed out are finished.
+    return search_dispatch(search);
+}
+
+int wordle_solve_wait(wordle_t *wordle) {
+    if (!wordle->solving) {
+        return WORDLE_ERR_ARGS;
+    }
+
+    pthread_mutex_lock(&wordle->mutex);
+    while (!wordle->search_done) {
+        pthread_cond_wait(&wordle->search_finished, &wordle->mutex);
+    }
+    pthread_mutex_unlock(&wordle->mutex);
+
+    wordle->solving = false;
+
+    search_t *search = &wordle->search;
+    if (search->scores != NULL) {
+        // Only the best ones were kept, they can be reported now
+        topk_heap_sort(&search->top);
+
+        for (size_t i = 0; search->on_solution != NULL && i < search->top.count; i++) {
+            topk_entry_t *entry = &search->top.entries[i];
+            wordle_solution_t solution = {
+                .chunk = -1,
+                .chunk_start = -1,
+                .chunk_end = -1,
+                .score = entry->score
+            };
+
+            for (int w = 0; w < SOLUTION_WORDS; w++) {
+                solution.words[w] = search->all_words[entry->words[w]].str;
+            }
+
+            search->on_solution(&solution, search->user_data);
+        }
+    }
+
+    search_cleanup(search);
+
+    return WORDLE_OK;
+}
+
+int wordle_solve(wordle_t *wordle, wordle_callback_t callback, void *user_data) {
+    int error = wordle_solve_start(wordle, callback, user_data);
+    if (!wordle->solving) {
+        return error;
+    }
+
+    int wait_error = wordle_solve_wait(wordle);
+
+    return error != WORDLE_OK ? error : wait_error;
+}
+
+int wordle_solve_buffer(wordle_t *wordle, wordle_solution_t *solutions, size_t capacity, size_t *count) {
+    solution_buffer_t buffer = {
+        .solutions = solutions,
+        .capacity = capacity
+    };
+    atomic_init(&buffer.count, 0);
+
+    int error = wordle_solve(wordle, store_solution, &buffer);
+    *count = atomic_load(&buffer.count);
+
+    return error;
+}
+
+void wordle_get_stats(const wordle_t *wordle, wordle_stats_t *stats) {
+    const search_t *search = &wordle->search;
+
+    stats->word_count = wordle->words.word_count;
+    stats->words_encountered = wordle->words.words_encountered;
+    stats->collisions = wordle->words.collisions;
+    stats->order = wordle->options.order;
+    stats->load_ms = wordle->load_ms;
+    stats->solve_ms = 0;
+    stats->leaves = 0;
+    stats->solutions = 0;
+    stats->cache_lookups = 0;
+    stats->cache_hits = 0;
+    stats->cache_evictions = 0;
+    stats->cache_bytes = 0;
+
+    if (search->manager == NULL) {
+        return;
+    }
+
+    mutex_lock(search->manager);
+    stats->leaves = search->work_done;
+    stats->solutions = search->solutions;
+    stats->cache_lookups = search->memo_counters.lookups;
+    stats->cache_hits = search->memo_counters.hits;
+    stats->cache_evictions = search->memo_counters.evictions;
+    mutex_unlock(search->manager);
+
+    stats->cache_bytes = search->memo_bytes;
+
+    if (!wordle->solving) {
+        stats->solve_ms = search_elapsed_ms(search);
+    }
+}
+
+void wordle_destroy(wordle_t *wordle) {
+    if (wordle == NULL) {
+        return;
+    }
+
+    if (wordle->solving) {
+        wordle_solve_wait(wordle);
+    }
+
+    if (wordle->words.all_words != NULL) {
+        cleanup_words(wordle->words.all_words, wordle->words.word_count);
+    }
+
+    cleanup_scores(&wordle->scores);
+    wordle_pool_destroy(wordle->owned_pool);
+    pthread_mutex_destroy(&wordle->mutex);
+    pthread_cond_destroy(&wordle->search_finished);
+    free(wordle);
+}
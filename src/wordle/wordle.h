@@ -0,0 +1,385 @@
+#ifndef WORDLE_H
+#define WORDLE_H
+
+#include <stddef.h>
+
+/**
+ * libwordle
+ *
+ * Finds all combinations of five five-letter words with 25 unique letters.
+ * Everything lives in a `wordle_t` context, so any number of independent
+ * solves can run in the same process.
+ *
+ *     wordle_t *wordle;
+ *     wordle_create(&wordle, NULL);
+ *     wordle_load(wordle, "words.txt");
+ *     wordle_solve(wordle, on_solution, NULL);
+ *     wordle_destroy(wordle);
+ *
+ * Every function that can fail returns a `wordle_error_t`.
+ */
+
+/**
+ * Marks the functions exported from the shared library. Everything else
+ * is built with hidden visibility, so the internals can't clash with
+ * symbols of the program embedding the library.
+ */
+#if defined(__GNUC__)
+#define WORDLE_API __attribute__((visibility("default")))
+#else
+#define WORDLE_API
+#endif
+
+/** Error codes. */
+typedef enum {
+    /** No error. */
+    WORDLE_OK = 0,
+
+    /** An argument or option was invalid. */
+    WORDLE_ERR_ARGS,
+
+    /** The words file could not be read. */
+    WORDLE_ERR_IO,
+
+    /** Ran out of memory. */
+    WORDLE_ERR_NO_MEMORY,
+
+    /** Too many distinct words for the anagram hashmap. */
+    WORDLE_ERR_HASHMAP_FULL,
+
+    /** More words than a neighbor list can index. */
+    WORDLE_ERR_TOO_MANY_WORDS,
+
+    /** Creating or synchronizing threads failed. */
+    WORDLE_ERR_THREADS,
+
+    /** `wordle_solve` was called before `wordle_load`. */
+    WORDLE_ERR_NOT_LOADED,
+
+    /** A solve is already running on this context. */
+    WORDLE_ERR_BUSY
+} wordle_error_t;
+
+/**
+ * Orders in which the words can be searched through.
+ *
+ * Only forward edges are stored (every word's neighbors come after it),
+ * so the order decides how big each subtree of the search is.
+ */
+typedef enum {
+    /** By the numeric representation. */
+    WORDLE_ORDER_NUMERIC,
+
+    /** Words containing the rarest letters first. */
+    WORDLE_ORDER_RAREST_LETTER,
+
+    /** Words with the fewest non-overlapping words first. */
+    WORDLE_ORDER_DEGREE_ASC,
+
+    /** Words with the most non-overlapping words first. */
+    WORDLE_ORDER_DEGREE_DESC,
+
+    /** Degeneracy ordering, every word has as few neighbors after it as possible. */
+    WORDLE_ORDER_DEGENERACY,
+
+    /** Number of orderings, also returned by `wordle_parse_order` for unknown names. */
+    WORDLE_ORDER_COUNT
+} wordle_order_t;
+
+/** How words are scored when only the best solutions are wanted. */
+typedef enum {
+    /** By the frequency from the words file, `word frequency` per line. */
+    WORDLE_SCORE_FREQUENCY,
+
+    /** By how many of the loaded words use each of the word's letters. */
+    WORDLE_SCORE_LETTERS,
+
+    /** Number of score models, also returned by `wordle_parse_score` for unknown names. */
+    WORDLE_SCORE_COUNT
+} wordle_score_t;
+
+/** A set of threads, can be shared by several contexts. */
+typedef struct wordle_pool wordle_pool_t;
+
+/** A solver context. */
+typedef struct wordle wordle_t;
+
+/** Options for `wordle_create`. */
+typedef struct {
+    /**
+     * Max number of threads running at a time.
+     * Only used when `pool` is NULL, in which case the context gets its own pool.
+     */
+    int max_threads;
+
+    /** Number of words each thread should try for the first position. */
+    int words_per_thread;
+
+    /** Order to search the words in. */
+    wordle_order_t order;
+
+    /**
+     * Only find the `top_k` best scoring solutions, 0 to find all of them.
+     * Subtrees which can't beat the K-th best solution found so far are skipped.
+     */
+    size_t top_k;
+
+    /** How to score the words when `top_k` is set. A solution's score is the sum of its words' scores. */
+    wordle_score_t score;
+
+    /**
+     * Most entries in the cache of ways to finish a solution given the first three
+     * words, shared by the threads of a solve. 0 to not cache.
+     * The cache is sized from the number of words loaded, up to this many entries.
+     * Each entry takes 32 bytes, rounded up to a power of 2 entries.
+     */
+    size_t cache_entries;
+
+    /**
+     * Pool to run the search on, NULL to create one for this context.
+     * A shared pool must outlive every context using it.
+     */
+    wordle_pool_t *pool;
+} wordle_options_t;
+
+/** A single solution. */
+typedef struct {
+    /** The five words, owned by the context and valid until the next load or destroy. */
+    const char *words[5];
+
+    /** The chunk of the search that found this solution. */
+    int chunk;
+
+    /** Index of the first word of the chunk. */
+    int chunk_start;
+
+    /** Index after the last word of the chunk. */
+    int chunk_end;
+
+    /** Score of the solution, 0 unless only the best solutions were asked for. */
+    unsigned long long int score;
+} wordle_solution_t;
+
+/**
+ * Called for every solution.
+ * Called from the worker threads, possibly several at a time.
+ *
+ * With `top_k` set, it's instead called once the search is done, for every one
+ * of the best solutions from the best to the worst, on the thread waiting for the solve.
+ * The chunk fields are -1 then.
+ *
+ * @param solution The solution, only valid during the call.
+ * @param user_data Whatever was passed to `wordle_solve`.
+ */
+typedef void (*wordle_callback_t)(const wordle_solution_t *solution, void *user_data);
+
+/** Stats about the words loaded into a context and its last solve. */
+typedef struct {
+    /** Words left after filtering. */
+    int word_count;
+
+    /** Total words encountered in the file. */
+    int words_encountered;
+
+    /** Hashmap collisions when filtering out the anagrams. */
+    int collisions;
+
+    /** Order the words are currently sorted in. */
+    wordle_order_t order;
+
+    /** Milliseconds spent loading, or re-ordering, the words. */
+    double load_ms;
+
+    /** Milliseconds the last solve took. */
+    double solve_ms;
+
+    /** Five-word combination leaves checked by the last solve. */
+    unsigned long long int leaves;
+
+    /** Solutions found by the last solve. */
+    unsigned long long int solutions;
+
+    /** Cache lookups by the last solve, one for every first three words that could be finished. */
+    unsigned long long int cache_lookups;
+
+    /** Lookups which found the completions in the cache. */
+    unsigned long long int cache_hits;
+
+    /** Entries replaced by completions for other letters when the cache was full. */
+    unsigned long long int cache_evictions;
+
+    /** Bytes the cache took up, 0 if the last solve didn't cache. */
+    size_t cache_bytes;
+} wordle_stats_t;
+
+/**
+ * Fills in the default options.
+ *
+ * @param options The options.
+ */
+WORDLE_API void wordle_options_init(wordle_options_t *options);
+
+/**
+ * Describes an error code.
+ *
+ * @param error The error code.
+ * @return const char*
+ */
+WORDLE_API const char* wordle_strerror(int error);
+
+/**
+ * Name of an ordering, as accepted by `wordle_parse_order`.
+ *
+ * @param order The ordering.
+ * @return const char*
+ */
+WORDLE_API const char* wordle_order_name(wordle_order_t order);
+
+/**
+ * Looks up an ordering by its name.
+ *
+ * @param name Name of the ordering.
+ * @return wordle_order_t WORDLE_ORDER_COUNT if there's no such ordering.
+ */
+WORDLE_API wordle_order_t wordle_parse_order(const char *name);
+
+/**
+ * Name of a score model, as accepted by `wordle_parse_score`.
+ *
+ * @param score The score model.
+ * @return const char*
+ */
+WORDLE_API const char* wordle_score_name(wordle_score_t score);
+
+/**
+ * Looks up a score model by its name.
+ *
+ * @param name Name of the score model.
+ * @return wordle_score_t WORDLE_SCORE_COUNT if there's no such model.
+ */
+WORDLE_API wordle_score_t wordle_parse_score(const char *name);
+
+/**
+ * Creates a pool of threads which can be shared between contexts.
+ *
+ * @param pool Set to the new pool.
+ * @param max_threads Max number of threads running at a time.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_pool_create(wordle_pool_t **pool, int max_threads);
+
+/**
+ * Destroys a pool. No context may be solving on it anymore.
+ *
+ * @param pool The pool, may be NULL.
+ */
+WORDLE_API void wordle_pool_destroy(wordle_pool_t *pool);
+
+/**
+ * Five-word combination leaves checked by every solve that ran on the pool so far.
+ *
+ * @param pool The pool.
+ * @return unsigned long long int
+ */
+WORDLE_API unsigned long long int wordle_pool_leaves(wordle_pool_t *pool);
+
+/**
+ * Creates a context.
+ *
+ * @param wordle Set to the new context.
+ * @param options Options, NULL for the defaults.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_create(wordle_t **wordle, const wordle_options_t *options);
+
+/**
+ * Loads a words file, replacing whatever was loaded before.
+ * Filters out words which can't be part of a solution and anagrams,
+ * and builds the search graph in the order from the options.
+ *
+ * @param wordle The context.
+ * @param filename Path to the words file, one five-letter word per line.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_load(wordle_t *wordle, const char *filename);
+
+/**
+ * Re-sorts the loaded words and rebuilds the search graph to match.
+ * If it fails, the words stay loaded in the order they were in.
+ *
+ * @param wordle The context.
+ * @param order The new order.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_set_order(wordle_t *wordle, wordle_order_t order);
+
+/**
+ * Changes the most entries in the cache of completions for the next solves,
+ * see `wordle_options_t.cache_entries`. 0 turns the cache off.
+ *
+ * @param wordle The context.
+ * @param entries Most entries in the cache.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_set_cache(wordle_t *wordle, size_t entries);
+
+/**
+ * Finds all solutions, blocks until done.
+ *
+ * @param wordle The context.
+ * @param callback Called for every solution, NULL to only count them.
+ * @param user_data Passed to the callback.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_solve(wordle_t *wordle, wordle_callback_t callback, void *user_data);
+
+/**
+ * Finds all solutions and stores them in a buffer, blocks until done.
+ *
+ * @param wordle The context.
+ * @param solutions Buffer for the solutions.
+ * @param capacity How many solutions fit in the buffer.
+ * @param count Set to the number of solutions found, may be more than `capacity`
+ *              in which case only the first `capacity` were stored.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_solve_buffer(wordle_t *wordle, wordle_solution_t *solutions, size_t capacity, size_t *count);
+
+/**
+ * Starts a solve without waiting for it to finish. Returns once every chunk
+ * of the search has been handed out to the pool, so the pool's threads may
+ * be kept busy by starting another context's solve right after.
+ *
+ * Must be followed by `wordle_solve_wait`.
+ *
+ * @param wordle The context.
+ * @param callback Called for every solution, NULL to only count them.
+ * @param user_data Passed to the callback.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_solve_start(wordle_t *wordle, wordle_callback_t callback, void *user_data);
+
+/**
+ * Waits for a solve started with `wordle_solve_start` to finish.
+ *
+ * @param wordle The context.
+ * @return int wordle_error_t
+ */
+WORDLE_API int wordle_solve_wait(wordle_t *wordle);
+
+/**
+ * Stats about the loaded words and the last solve.
+ *
+ * @param wordle The context.
+ * @param stats Filled in with the stats.
+ */
+WORDLE_API void wordle_get_stats(const wordle_t *wordle, wordle_stats_t *stats);
+
+/**
+ * Destroys a context. Must not be solving.
+ *
+ * @param wordle The context, may be NULL.
+ */
+WORDLE_API void wordle_destroy(wordle_t *wordle);
+
+#endif
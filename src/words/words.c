@@ -22,11 +22,6 @@
  */
 #define hash32(x) (uint16_t) (((x * 5351) & 0xffff) ^ ((x & 0xffff0000) >> 16))
 
-/**
- * Used to filter out anagrams.
- */
-static uint32_t hashmap[1 << HASHMAP_SIZE];
-static int collisions = 0;
 
 /**
  * Calculates number of set bits (1s) in a number.
@@ -46,6 +41,61 @@ static uint8_t number_of_bits(uint32_t n) {
     return result;
 }
 
+/**
+ * Reads a word and its optional frequency from a line of the words file.
+ * Lowercases the word in place.
+ *
+ * @param line The line, `word [frequency]`.
+ * @param word Set to the start of the word, which gets NUL terminated.
+ * @param frequency Set to the frequency, 0 if there is none or it isn't a non-negative number.
+ * @return bool Whether the line holds a five-letter word.
+ */
+static bool parse_line(char *line, char **word, uint32_t *frequency) {
+    while (isspace((unsigned char) *line)) {
+        line++;
+    }
+
+    *word = line;
+    int length = 0;
+    while (isalpha((unsigned char) line[length])) {
+        line[length] = tolower((unsigned char) line[length]);
+        length++;
+    }
+
+    if (length != 5 || (line[length] != '\0' && !isspace((unsigned char) line[length]))) {
+        return false;
+    }
+
+    // Only followed by a frequency if there is something after the word, the last line may end right after it
+    bool has_rest = line[length] != '\0';
+    line[length] = '\0';
+    *frequency = 0;
+
+    if (has_rest) {
+        char *rest = line + length + 1;
+        while (isspace((unsigned char) *rest)) {
+            rest++;
+        }
+
+        // strtoul would take a sign too, and wrap a negative frequency around to a huge one
+        if (isdigit((unsigned char) *rest)) {
+            char *end;
+            unsigned long value = strtoul(rest, &end, 10);
+
+            while (isspace((unsigned char) *end)) {
+                end++;
+            }
+
+            // Anything else after the digits and it's not a number, like a missing one
+            if (*end == '\0') {
+                *frequency = value > UINT32_MAX ? UINT32_MAX : (uint32_t) value;
+            }
+        }
+    }
+
+    return true;
+}
+
 /**
  * Creates a bitfield which holds information about
  * which characters the word uses.
@@ -75,15 +125,38 @@ static uint32_t numeric_representation(char *word) {
     return number;
 }
 
-static bool should_keep_word(uint32_t word_num) {
+/**
+ * Decides whether a word is worth keeping.
+ *
+ * @param word_num Numeric representation of the word.
+ * @param index Index the word will be stored at, if it's kept.
+ * @param hashmap Hashmap used to filter out anagrams, 1 << HASHMAP_SIZE elements.
+ * @param hashmap_words Index of the word stored in each hashmap slot.
+ * @param collisions Incremented for every hashmap collision.
+ * @param keep Set to whether the word should be kept.
+ * @param anagram_of Set to the index of the word this one is an anagram of, -1 if none.
+ * @return int wordle_error_t
+ */
+static int should_keep_word(
+    uint32_t word_num,
+    int index,
+    uint32_t *hashmap,
+    int *hashmap_words,
+    int *collisions,
+    bool *keep,
+    int *anagram_of
+) {
+    *keep = false;
+    *anagram_of = -1;
+
     // Number of unique characters has to be 5
     if (number_of_bits(word_num) != 5) {
-        return false;
+        return WORDLE_OK;
     }
     
     // Number of vowels
     if (number_of_bits(word_num & VOWELS_MASK) >= 3) {
-        return false;
+        return WORDLE_OK;
     }
 
     unsigned int hashmap_key = hash32(word_num);
@@ -92,46 +165,316 @@ static bool should_keep_word(uint32_t word_num) {
         // Empty space, store this number and keep the word
         if (hashmap[hashmap_key] == 0) {
             hashmap[hashmap_key] = word_num;
-            return true;
+            hashmap_words[hashmap_key] = index;
+            *keep = true;
+            return WORDLE_OK;
         }
 
         // Word was found in the hashmap
         if (hashmap[hashmap_key] == word_num) {
             // This word should not be kept, since there is an anagram for it already
-            return false;
+            *anagram_of = hashmap_words[hashmap_key];
+            return WORDLE_OK;
         }
 
         // Keep searching, linear probing
         hashmap_key++;
-        collisions++;
+        (*collisions)++;
     }
 
-    fprintf(stderr, "Failed to insert %d into a hashmap %u %u\n", word_num, hash32(word_num), hashmap_key);
-    exit(EXIT_FAILURE);
+    // Ran off the end of the hashmap
+    return WORDLE_ERR_HASHMAP_FULL;
 }
 
-int compare_words(const void *a, const void *b) {
-    word_t *word_a = (word_t *) a;
-    word_t *word_b = (word_t *) b;
+/** Names of the orderings, indexed by `wordle_order_t`. */
+static const char *order_names[WORDLE_ORDER_COUNT] = {
+    [WORDLE_ORDER_NUMERIC] = "numeric",
+    [WORDLE_ORDER_RAREST_LETTER] = "rarest",
+    [WORDLE_ORDER_DEGREE_ASC] = "degree-asc",
+    [WORDLE_ORDER_DEGREE_DESC] = "degree-desc",
+    [WORDLE_ORDER_DEGENERACY] = "degeneracy"
+};
+
+/** A word's position before sorting, along with what it should be sorted by. */
+typedef struct {
+    uint32_t key;
+    uint32_t numeric;
+    int index;
+} sort_entry_t;
+
+static int compare_sort_entries(const void *a, const void *b) {
+    sort_entry_t *entry_a = (sort_entry_t *) a;
+    sort_entry_t *entry_b = (sort_entry_t *) b;
+
+    if (entry_a->key != entry_b->key) {
+        return entry_a->key < entry_b->key ? -1 : 1;
+    }
+
+    // Ties are broken by the numeric representation, same as the default ordering
+    return (int) entry_a->numeric - (int) entry_b->numeric;
+}
+
+/**
+ * Calculates the degree of every word, the number of other words
+ * it has no character overlap with.
+ *
+ * @param words Array of words.
+ * @param word_count Word count.
+ * @return int* Dynamically allocated array of degrees, NULL if out of memory.
+ */
+static int* word_degrees(word_t *words, int word_count) {
+    // + 1 so that there's something to allocate for 0 words
+    int *degrees = (int *) calloc(word_count + 1, sizeof(int));
+    if (degrees == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < word_count; i++) {
+        for (int j = i + 1; j < word_count; j++) {
+            if ((words[i].numeric & words[j].numeric) == 0) {
+                degrees[i]++;
+                degrees[j]++;
+            }
+        }
+    }
+
+    return degrees;
+}
+
+/**
+ * Fills in the sort keys for the given ordering.
+ *
+ * @param words Array of words.
+ * @param word_count Word count.
+ * @param order The ordering.
+ * @param entries Sort entries, one per word, `index` and `numeric` already set.
+ * @return int wordle_error_t
+ */
+static int fill_sort_keys(word_t *words, int word_count, wordle_order_t order, sort_entry_t *entries) {
+    switch (order) {
+        case WORDLE_ORDER_RAREST_LETTER: {
+            // How many words use each letter
+            int letter_counts[26] = { 0 };
+            for (int i = 0; i < word_count; i++) {
+                for (int c = 0; c < 26; c++) {
+                    if (words[i].numeric & (1 << c)) {
+                        letter_counts[c]++;
+                    }
+                }
+            }
+
+            // Words containing the rarest letters go first
+            for (int i = 0; i < word_count; i++) {
+                uint32_t rarest = UINT32_MAX;
+                for (int c = 0; c < 26; c++) {
+                    if ((words[i].numeric & (1 << c)) && letter_counts[c] < rarest) {
+                        rarest = letter_counts[c];
+                    }
+                }
+
+                entries[i].key = rarest;
+            }
+            break;
+        }
+
+        case WORDLE_ORDER_DEGREE_ASC:
+        case WORDLE_ORDER_DEGREE_DESC: {
+            int *degrees = word_degrees(words, word_count);
+            if (degrees == NULL) {
+                return WORDLE_ERR_NO_MEMORY;
+            }
+
+            for (int i = 0; i < word_count; i++) {
+                entries[i].key = order == WORDLE_ORDER_DEGREE_ASC
+                    ? (uint32_t) degrees[i]
+                    : (uint32_t) (word_count - degrees[i]);
+            }
+
+            free(degrees);
+            break;
+        }
+
+        case WORDLE_ORDER_DEGENERACY: {
+            /**
+             * Keep removing the word with the fewest remaining neighbors.
+             * The order of removal is the degeneracy ordering, in which every
+             * word has as few neighbors after it as possible. Since only forward
+             * edges are stored, this keeps every neighbor list short.
+             */
+            int *degrees = word_degrees(words, word_count);
+            bool *removed = (bool *) calloc(word_count + 1, sizeof(bool));
+            if (degrees == NULL || removed == NULL) {
+                free(degrees);
+                free(removed);
+                return WORDLE_ERR_NO_MEMORY;
+            }
+
+            for (int step = 0; step < word_count; step++) {
+                int min = -1;
+                for (int i = 0; i < word_count; i++) {
+                    if (!removed[i] && (min == -1 || degrees[i] < degrees[min])) {
+                        min = i;
+                    }
+                }
+
+                removed[min] = true;
+                entries[min].key = step;
+
+                for (int i = 0; i < word_count; i++) {
+                    if (!removed[i] && (words[i].numeric & words[min].numeric) == 0) {
+                        degrees[i]--;
+                    }
+                }
+            }
+
+            free(removed);
+            free(degrees);
+            break;
+        }
+
+        case WORDLE_ORDER_NUMERIC:
+        default:
+            for (int i = 0; i < word_count; i++) {
+                entries[i].key = 0;
+            }
+            break;
+    }
+
+    return WORDLE_OK;
+}
+
+const char* wordle_order_name(wordle_order_t order) {
+    return order >= 0 && order < WORDLE_ORDER_COUNT ? order_names[order] : "unknown";
+}
+
+wordle_order_t wordle_parse_order(const char *name) {
+    for (int i = 0; i < WORDLE_ORDER_COUNT; i++) {
+        if (strcmp(name, order_names[i]) == 0) {
+            return (wordle_order_t) i;
+        }
+    }
+
+    return WORDLE_ORDER_COUNT;
+}
+
+int order_words(word_results_t *results, wordle_order_t order) {
+    word_t *words = results->all_words;
+    int total = results->word_count;
+
+    if (order < 0 || order >= WORDLE_ORDER_COUNT) {
+        return WORDLE_ERR_ARGS;
+    }
+
+    // Neighbor lists store indexes as uint16_t, and chunks end one past the last index in one
+    if (total > UINT16_MAX) {
+        return WORDLE_ERR_TOO_MANY_WORDS;
+    }
+
+    // + 1 so that there's something to allocate for 0 words
+    sort_entry_t *entries = (sort_entry_t *) calloc(total + 1, sizeof(sort_entry_t));
+    word_t *sorted = (word_t *) calloc(total + 1, sizeof(word_t));
+    if (entries == NULL || sorted == NULL) {
+        free(entries);
+        free(sorted);
+        return WORDLE_ERR_NO_MEMORY;
+    }
+
+    for (int i = 0; i < total; i++) {
+        entries[i].index = i;
+        entries[i].numeric = words[i].numeric;
+    }
+
+    int error = fill_sort_keys(words, total, order, entries);
+    if (error != WORDLE_OK) {
+        free(entries);
+        free(sorted);
+        return error;
+    }
+
+    qsort(entries, total, sizeof(sort_entry_t), compare_sort_entries);
+
+    for (int i = 0; i < total; i++) {
+        sorted[i] = words[entries[i].index];
+    }
+
+    free(entries);
+
+    /**
+     * Section below does the following:
+     * For every word W, creates an array that stores indexes of
+     * every other words that have 0 character overlap with W.
+     * This way, when we're trying out all the combinations where
+     * W is present, we can efficiently try out words that definitely
+     * work with W.
+     *
+     * The new lists are built next to the old ones, so that the words
+     * can be left as they were if there's not enough memory.
+     */
+    for (int i = 0; i < total; i++) {
+        // + 1 so that the last word gets an allocation too
+        uint16_t *neighbors = (uint16_t *) calloc(total - i, sizeof(uint16_t));
+        if (neighbors == NULL) {
+            for (int j = 0; j < i; j++) {
+                free(sorted[j].neighbors);
+            }
+            free(sorted);
+            return WORDLE_ERR_NO_MEMORY;
+        }
+
+        int n = 0;
+        for (int j = i + 1; j < total; j++) {
+            // If there is a bitwise overlap, they share a character
+            if (sorted[i].numeric & sorted[j].numeric) {
+                continue;
+            }
 
-    return (int) word_a->numeric - (int) word_b->numeric;
+            // Store the index of the compatible word
+            neighbors[n++] = (uint16_t) j;
+        }
+
+        sorted[i].neighbors = neighbors;
+        sorted[i].neighbors_n = n;
+    }
+
+    // The old lists refer to the old positions
+    for (int i = 0; i < total; i++) {
+        free(words[i].neighbors);
+    }
+
+    memcpy(words, sorted, total * sizeof(word_t));
+    free(sorted);
+
+    results->order = order;
+
+    return WORDLE_OK;
 }
 
-word_results_t load_words() {
-    FILE *file = fopen("words.txt", "r");
+int load_words(const char *filename, wordle_order_t order, word_results_t *results) {
+    memset(results, 0, sizeof(word_results_t));
+
+    FILE *file = fopen(filename, "r");
     if (file == NULL) {
-        perror("Error opening file: ");
-        exit(EXIT_FAILURE);
+        return WORDLE_ERR_IO;
     }
 
+    /**
+     * Used to filter out anagrams. Allocated per call, so that several
+     * files can be loaded at the same time.
+     */
+    uint32_t *hashmap = (uint32_t *) calloc(1 << HASHMAP_SIZE, sizeof(uint32_t));
+    int *hashmap_words = (int *) calloc(1 << HASHMAP_SIZE, sizeof(int));
     word_t *words = (word_t *) calloc(WORDS_PER_ALLOC, sizeof(word_t));
-    if (words == NULL) {
-        perror("calloc");
-        exit(EXIT_FAILURE);
+    if (hashmap == NULL || hashmap_words == NULL || words == NULL) {
+        free(hashmap);
+        free(hashmap_words);
+        free(words);
+        fclose(file);
+        return WORDLE_ERR_NO_MEMORY;
     }
+    int collisions = 0;
+    int error = WORDLE_OK;
 
     memset(words, 0, WORDS_PER_ALLOC * sizeof(word_t));
-    memset(hashmap, 0, sizeof(hashmap));
 
     int i = 0;
     // How many pointers we have allocated, not bytes, pointers
@@ -140,92 +483,115 @@ word_results_t load_words() {
     // Total words encountered in a file, even unused ones
     int total_words = 0;
 
-    char line[6];
-    while (!feof(file)) {
-        size_t nread = fread(line, sizeof(char), sizeof(line), file);
-        if (line[nread - 1] == '\n') {
-            line[nread - 1] = '\0';
-        }
-        
+    // A word, optionally followed by its frequency
+    char line[64];
+    while (fgets(line, sizeof(line), file) != NULL) {
         total_words++;
-        uint32_t numeric = numeric_representation(line);
-        if (!should_keep_word(numeric)) {
+
+        /**
+         * No word with a frequency takes up this much, skip the whole line
+         * rather than reading what's left of it as lines of their own.
+         */
+        size_t line_length = strlen(line);
+        if (line_length == sizeof(line) - 1 && line[line_length - 1] != '\n') {
+            int c;
+            while ((c = fgetc(file)) != EOF && c != '\n') {
+            }
+            continue;
+        }
+
+        char *word;
+        uint32_t frequency;
+        if (!parse_line(line, &word, &frequency)) {
+            continue;
+        }
+
+        uint32_t numeric = numeric_representation(word);
+        bool keep;
+        int anagram_of;
+        error = should_keep_word(numeric, i, hashmap, hashmap_words, &collisions, &keep, &anagram_of);
+        if (error != WORDLE_OK) {
+            break;
+        }
+
+        // Anagrams are interchangeable, so keep whichever is the most frequent
+        if (anagram_of != -1 && frequency > words[anagram_of].frequency) {
+            char *str = strdup(word);
+            if (str == NULL) {
+                error = WORDLE_ERR_NO_MEMORY;
+                break;
+            }
+
+            free(words[anagram_of].str);
+            words[anagram_of].str = str;
+            words[anagram_of].frequency = frequency;
+        }
+
+        if (!keep) {
             continue;
         }
 
         // We're about to include this word as well
         if (i >= allocated) {
             // allocate another chunk of words
-            words = realloc(words, (allocated + WORDS_PER_ALLOC) * sizeof(word_t));
-            if (words == NULL) {
-                perror("realloc");
-                exit(EXIT_FAILURE);
+            word_t *more_words = realloc(words, (allocated + WORDS_PER_ALLOC) * sizeof(word_t));
+            if (more_words == NULL) {
+                error = WORDLE_ERR_NO_MEMORY;
+                break;
             }
+            words = more_words;
 
             // Initialize the new memory
             memset(words + allocated, 0, WORDS_PER_ALLOC * sizeof(word_t));
             allocated += WORDS_PER_ALLOC;
         }
         
-        words[i].str = strdup(line);
+        words[i].str = strdup(word);
         words[i].numeric = numeric;
+        words[i].frequency = frequency;
         words[i].neighbors = NULL;
         words[i].neighbors_n = 0;
 
         if (words[i].str == NULL) {
-            perror("strdup");
-            exit(EXIT_FAILURE);
+            error = WORDLE_ERR_NO_MEMORY;
+            break;
         }
 
         i++;
     }
 
-    int total = i;
-    /**
-     * Sort based on the numeric representation of the numbers.
-     */
-    qsort(words, total, sizeof(word_t), compare_words);
+    if (error == WORDLE_OK && ferror(file)) {
+        error = WORDLE_ERR_IO;
+    }
 
-    /**
-     * Section below does the following:
-     * For every word W, creates an array that stores indexes of
-     * every other words that have 0 character overlap with W.
-     * This way, when we're trying out all the combinations where
-     * W is present, we can efficiently try out words that definitely
-     * work with W.
-     */
-    for (int i = 0; i < total; i++) {
-        uint16_t *neighbors = (uint16_t *) calloc(total - i - 1, sizeof(uint16_t));
+    fclose(file);
+    free(hashmap);
+    free(hashmap_words);
 
-        int n = 0;
-        for (int j = i + 1; j < total; j++) {
-            // If there is a bitwise overlap, they share a character
-            if (words[i].numeric & words[j].numeric) {
-                continue;
-            }
+    int total = i;
 
-            // Store the index of the compatible word
-            neighbors[n++] = (uint16_t) j;
-        }
+    results->all_words = words;
+    results->word_count = total;
+    results->words_encountered = total_words;
+    results->collisions = collisions;
 
-        words[i].neighbors = neighbors;
-        words[i].neighbors_n = n;
+    if (error == WORDLE_OK) {
+        error = order_words(results, order);
     }
 
-    word_results_t results = {
-        .all_words = words,
-        .word_count = total,
-        .words_encountered = total_words,
-        .collisions = collisions
-    };
+    if (error != WORDLE_OK) {
+        cleanup_words(words, total);
+        memset(results, 0, sizeof(word_results_t));
+    }
 
-    return results;
+    return error;
 }
 
 void cleanup_words(word_t *all_words, int word_count) {
     for (int i = 0; i < word_count; i++) {
-        // Free up the strings
+        // Free up the strings and the neighbor lists
         free(all_words[i].str);
+        free(all_words[i].neighbors);
     }
 
     free(all_words);
@@ -1,5 +1,9 @@
+#ifndef WORDS_H
+#define WORDS_H
+
 #include <stdint.h>
 #include <stdbool.h>
+#include "../wordle/wordle.h"
 
 /**
  * Represents a single word.
@@ -11,6 +15,9 @@ typedef struct {
     /** Numeric representation of the word. */
     uint32_t numeric;
 
+    /** Frequency from the words file, 0 if it has none. */
+    uint32_t frequency;
+
     /**
      * Array containing indexes of all the words that have no character
      * overlap with this word.
@@ -20,6 +27,13 @@ typedef struct {
     /** Length of said array. */
     uint16_t neighbors_n;
 
+    /**
+     * Score of the word for top-K searches, set by `score_words`.
+     * Kept here rather than next to the bounds, since the innermost loop
+     * of the search needs it along with `numeric`.
+     */
+    uint32_t score;
+
 } word_t;
 
 /**
@@ -42,6 +56,9 @@ typedef struct {
      * Hashmap collisions when filtering out the anagrams.
      */
     int collisions;
+
+    /** Order the words are currently sorted in. */
+    wordle_order_t order;
 } word_results_t;
 
 /**
@@ -49,8 +66,24 @@ typedef struct {
  * filters them so that there are no duplicate letter words,
  * and no anagrams, and generates their numeric representations
  * to simplify checking for overlaps.
+ *
+ * @param filename Path to the words file, one five-letter word per line,
+ *                 optionally followed by the word's frequency.
+ * @param order Order to sort the words in.
+ * @param results Filled in with the words, left empty on error.
+ * @return int wordle_error_t
+ */
+int load_words(const char *filename, wordle_order_t order, word_results_t *results);
+
+/**
+ * Sorts the words in a different order and rebuilds their neighbors to match.
+ * The words are left as they were if it fails.
+ *
+ * @param results Loaded words.
+ * @param order The new order.
+ * @return int wordle_error_t
  */
-word_results_t load_words();
+int order_words(word_results_t *results, wordle_order_t order);
 
 /**
  * Cleanup.
@@ -59,3 +92,5 @@ word_results_t load_words();
  * @param word_count Word count.
  */
 void cleanup_words(word_t *all_words, int word_count);
+
+#endif